@@ -0,0 +1,186 @@
+/////////////////////////////////////////////////////////////////////
+// Benchmark utilities: timing of UGens and JSON output
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _BENCHUTIL_H_
+#define _BENCHUTIL_H_
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+namespace Bench
+{
+
+/** Timing of one UGen configuration.
+*/
+struct Result
+{
+	std::string ugen, variant;
+	size_t vsize;
+	double nsPerSample, samplesPerSec;
+};
+
+/** Block timings of one scenario configuration. The real-time factor is
+	the processing time over the duration of the audio processed, so a
+	value below one means the graph runs in real time.
+*/
+struct ScenarioResult
+{
+	std::string scenario;
+	size_t voices, vsize, blocks;
+	double rtf, p50Us, p99Us, maxUs, deadlineUs;
+};
+
+/** Value of a sorted vector at quantile q, by nearest rank.
+*/
+inline double percentile(const std::vector<double>& sorted, double q)
+{
+	if (sorted.empty()) return 0.;
+	size_t rank = (size_t)std::ceil(q * sorted.size());
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+/** Summarise the block timings of a scenario. \n
+	scenario - name of the scenario. \n
+	voices - number of voices of the graph. \n
+	vsize - vector size. \n
+	sr - sampling rate. \n
+	blockNs - time of each block in nanoseconds, sorted in place.
+*/
+inline ScenarioResult summarise(const std::string& scenario, size_t voices, size_t vsize, double sr,
+	std::vector<double>& blockNs)
+{
+	std::sort(blockNs.begin(), blockNs.end());
+	double total = 0.;
+	for (double ns : blockNs) total += ns;
+
+	double deadlineNs = 1e9 * vsize / sr;
+	return ScenarioResult{ scenario, voices, vsize, blockNs.size(),
+		blockNs.empty() ? 0. : total / (deadlineNs * blockNs.size()),
+		percentile(blockNs, 0.5) * 1e-3, percentile(blockNs, 0.99) * 1e-3,
+		(blockNs.empty() ? 0. : blockNs.back()) * 1e-3, deadlineNs * 1e-3 };
+}
+
+/** Precomputed input signal: a sine between lo and hi with the given
+	number of cycles per vector, plus noise of the given amplitude.
+	Processing it costs nothing, so only the UGen under test is timed.
+*/
+class Signal : public UGen
+{
+public:
+	Signal(size_t vsiz, double lo, double hi, double cycles, double noise = 0., double sr = def_sr) :
+		UGen(vsiz, sr)
+	{
+		uint32_t seed = 22222;
+		for (size_t i = 0; i < m_s.size(); i++)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			double r = (double)seed / 4294967296. * 2. - 1.;
+			double s = 0.5 + 0.5 * std::sin(twopi * cycles * i / m_s.size());
+			m_s[i] = lo + (hi - lo) * s + noise * r;
+		}
+	};
+};
+
+/** Time one vector of processing, in nanoseconds. The number of vectors
+	per run is calibrated to last about minMs, and the best of reps runs
+	is kept, which is the least disturbed by the rest of the system.
+*/
+inline double timeVector(UGen& u, double minMs = 20., int reps = 5)
+{
+	typedef std::chrono::steady_clock Clock;
+	size_t iters = 1;
+	for (;;)
+	{
+		Clock::time_point t0 = Clock::now();
+		for (size_t k = 0; k < iters; k++) u.process();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+		if (ms >= minMs || iters >= ((size_t)1 << 30)) break;
+		iters *= ms > 0.1 ? (size_t)(minMs / ms) + 1 : 16;
+	}
+
+	double best = 0.;
+	for (int r = 0; r < reps; r++)
+	{
+		Clock::time_point t0 = Clock::now();
+		for (size_t k = 0; k < iters; k++) u.process();
+		double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / iters;
+		best = r == 0 || ns < best ? ns : best;
+	}
+	return best;
+}
+
+/** Time a UGen and return its result.
+*/
+inline Result measure(const std::string& ugen, const std::string& variant, UGen& u, double minMs = 20.)
+{
+	double ns = timeVector(u, minMs) / u.vsize();
+	return Result{ ugen, variant, u.vsize(), ns, 1e9 / ns };
+}
+
+/** Escape a string for JSON.
+*/
+inline std::string jsonString(const std::string& s)
+{
+	std::string out = "\"";
+	for (char c : s)
+	{
+		if (c == '"' || c == '\\') out += '\\';
+		out += c;
+	}
+	return out + "\"";
+}
+
+/** Write the results as a JSON document. \n
+	os - output stream. \n
+	suite - name of the benchmark suite. \n
+	results - timings to write.
+*/
+inline void writeJson(std::ostream& os, const std::string& suite, const std::vector<Result>& results)
+{
+	os << "{\n  \"suite\": " << jsonString(suite) << ",\n  \"sr\": " << def_sr << ",\n  \"results\": [";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		os << (i ? ",\n" : "\n") << "    {\"ugen\": " << jsonString(r.ugen) << ", \"variant\": " << jsonString(r.variant)
+			<< ", \"vsize\": " << r.vsize << ", \"ns_per_sample\": " << r.nsPerSample
+			<< ", \"samples_per_sec\": " << r.samplesPerSec << "}";
+	}
+	os << "\n  ]\n}\n";
+}
+
+/** Write the scenario results as a JSON document. \n
+	os - output stream. \n
+	suite - name of the benchmark suite. \n
+	results - block timings to write.
+*/
+inline void writeJson(std::ostream& os, const std::string& suite, const std::vector<ScenarioResult>& results)
+{
+	os << "{\n  \"suite\": " << jsonString(suite) << ",\n  \"sr\": " << def_sr << ",\n  \"results\": [";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const ScenarioResult& r = results[i];
+		os << (i ? ",\n" : "\n") << "    {\"scenario\": " << jsonString(r.scenario) << ", \"voices\": " << r.voices
+			<< ", \"vsize\": " << r.vsize << ", \"blocks\": " << r.blocks << ", \"rtf\": " << r.rtf
+			<< ", \"p50_us\": " << r.p50Us << ", \"p99_us\": " << r.p99Us << ", \"max_us\": " << r.maxUs
+			<< ", \"deadline_us\": " << r.deadlineUs << "}";
+	}
+	os << "\n  ]\n}\n";
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////
+// kiwiwaves_scenarios: real-time factor and block latency of patches
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include "BenchUtil.h"
+#include "ExternalUGen.h"
+#include "Osc.h"
+#include "FuncTab.h"
+#include "FourierTab.h"
+#include "Butterworth.h"
+#include "Reson.h"
+#include "Tone.h"
+#include "Delay.h"
+#include "Comb.h"
+#include "Envelopes.h"
+#include "Balance.h"
+#ifdef KIWIWAVES_TRACE
+#include "Trace.h"
+#endif
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Bench;
+
+struct Options
+{
+    const char* filter = nullptr;
+    double seconds = 2.;
+};
+
+/** A patch processed one block at a time. The UGens are owned by the
+    scenario and processed in dependency order, and the voices are
+    summed into a bus. The Iir filters process their input themselves,
+    so the UGens feeding them are not processed again.
+*/
+class Scenario
+{
+public:
+    Scenario(size_t vsiz) : m_bus(vsiz), m_mix(vsiz, 0.) { };
+    virtual ~Scenario() { };
+
+    virtual void block() = 0;
+
+protected:
+    ExternalUGen m_bus;
+    std::vector<double> m_mix;
+    std::vector<std::unique_ptr<UGen>> m_ugens;
+
+    template <class T, class... Args>
+    T& add(Args&&... args)
+    {
+        m_ugens.emplace_back(new T(std::forward<Args>(args)...));
+        return static_cast<T&>(*m_ugens.back());
+    }
+
+    void clearMix() { std::fill(m_mix.begin(), m_mix.end(), 0.); }
+
+    void mix(UGen& u)
+    {
+        const double* s = u.data();
+        for (size_t i = 0; i < m_mix.size(); i++) m_mix[i] += s[i];
+    }
+};
+
+/** N voices of OscI into LowP, with the amplitude of each oscillator
+    driven by a LineAdsr. Every voice plays half second notes, staggered
+    so that retrigs and releases land inside the blocks.
+*/
+class Poly : public Scenario
+{
+public:
+    Poly(size_t voices, size_t vsiz) : Scenario(vsiz), m_saw(20), m_pos(0)
+    {
+        for (size_t i = 0; i < voices; i++)
+        {
+            LineAdsr& env = add<LineAdsr>(0.01, 1., 0.1, 0.6, 0.2, true, vsiz);
+            OscI& osc = add<OscI>(env, 110. * (1. + i % 24 / 12.), m_saw, 0., 0., vsiz);
+            m_voices.push_back(Voice{ &env, &osc, &add<LowP>(osc, 800. + 100. * (i % 16), vsiz),
+                (size_t)(def_sr * 0.5 * i / voices) });
+        }
+    }
+
+    void block() override
+    {
+        size_t v = m_mix.size(), period = (size_t)(def_sr * 0.5), gate = (size_t)(def_sr * 0.3);
+        clearMix();
+        for (Voice& vc : m_voices)
+        {
+            // Note on and off of this voice that fall inside the block,
+            // the blocks are shorter than a note so there is one of each at most
+            size_t t = (m_pos + period - vc.start) % period;
+            size_t on = (period - t) % period, off = (gate + period - t) % period;
+            if (on < v) vc.env->scheduleRetrig(on);
+            if (off < v) vc.env->scheduleRelease(off);
+            vc.env->process();
+            vc.filt->process();
+            mix(*vc.filt);
+        }
+        m_bus.setData(m_mix.data(), v);
+        m_pos += v;
+    }
+
+private:
+    struct Voice
+    {
+        LineAdsr* env;
+        OscI* osc;
+        LowP* filt;
+        size_t start;
+    };
+
+    SawTab m_saw;
+    std::vector<Voice> m_voices;
+    size_t m_pos;
+};
+
+/** N channels of a sawtooth through a flanger: a Delay with feedback
+    whose delay time is swept by a slow sine Osc.
+*/
+class Flanger : public Scenario
+{
+public:
+    Flanger(size_t voices, size_t vsiz) : Scenario(vsiz), m_saw(20)
+    {
+        for (size_t i = 0; i < voices; i++)
+        {
+            Channel ch;
+            ch.src = &add<OscI>(0.5, 100. + 7. * i, m_saw, 0., 0., vsiz);
+            ch.lfo = &add<Osc>(0.002, 0.2 + 0.01 * i, m_sine, 0., 0.003, vsiz);
+            ch.del = &add<Delay>(*ch.src, 0.01, *ch.lfo, 0.7, true, vsiz);
+            m_channels.push_back(ch);
+        }
+    }
+
+    void block() override
+    {
+        clearMix();
+        for (Channel& ch : m_channels)
+        {
+            ch.src->process();
+            ch.lfo->process();
+            ch.del->process();
+            mix(*ch.src);
+            mix(*ch.del);
+        }
+        m_bus.setData(m_mix.data(), m_mix.size());
+    }
+
+private:
+    struct Channel
+    {
+        OscI* src;
+        Osc* lfo;
+        Delay* del;
+    };
+
+    SawTab m_saw;
+    SinTab m_sine;
+    std::vector<Channel> m_channels;
+};
+
+/** A bank of N parallel Comb filters with different delays on a
+    noise input, as in the early part of a reverb.
+*/
+class CombBank : public Scenario
+{
+public:
+    CombBank(size_t voices, size_t vsiz) : Scenario(vsiz), m_noise(vsiz, 0., 0., 0., 1.)
+    {
+        for (size_t i = 0; i < voices; i++)
+            m_combs.push_back(&add<Comb>(m_noise, 2., 0.05, 0.0113 + 0.00071 * (i % 48), false, vsiz));
+    }
+
+    void block() override
+    {
+        clearMix();
+        for (Comb* c : m_combs)
+        {
+            c->process();
+            mix(*c);
+        }
+        m_bus.setData(m_mix.data(), m_mix.size());
+    }
+
+private:
+    Signal m_noise;
+    std::vector<Comb*> m_combs;
+};
+
+/** N channels of an equalisation chain, HighP, ResonZ and ToneLP, whose
+    level is restored by a Balance against the dry channel. The sum goes
+    through a master HighP and Balance.
+*/
+class Mastering : public Scenario
+{
+public:
+    Mastering(size_t voices, size_t vsiz) : Scenario(vsiz), m_saw(20),
+        m_masterHp(m_bus, 20., vsiz), m_master(m_masterHp, m_bus, 10., addSmallNumber, vsiz)
+    {
+        for (size_t i = 0; i < voices; i++)
+        {
+            Channel ch;
+            ch.src = &add<OscI>(0.5, 55. * (1. + i % 12 / 12.), m_saw, 0., 0., vsiz);
+            ch.hp = &add<HighP>(*ch.src, 30., vsiz);
+            ch.eq = &add<ResonZ>(*ch.hp, 3000., 1000., vsiz);
+            ch.tone = &add<ToneLP>(*ch.eq, 12000., vsiz);
+            ch.bal = &add<Balance>(*ch.tone, *ch.src, 10., addSmallNumber, vsiz);
+            m_channels.push_back(ch);
+        }
+    }
+
+    void block() override
+    {
+        clearMix();
+        for (Channel& ch : m_channels)
+        {
+            ch.eq->process();
+            ch.tone->process();
+            ch.bal->process();
+            mix(*ch.bal);
+        }
+        m_bus.setData(m_mix.data(), m_mix.size());
+        m_masterHp.process();
+        m_master.process();
+    }
+
+private:
+    struct Channel
+    {
+        OscI* src;
+        HighP* hp;
+        ResonZ* eq;
+        ToneLP* tone;
+        Balance* bal;
+    };
+
+    SawTab m_saw;
+    std::vector<Channel> m_channels;
+    HighP m_masterHp;
+    Balance m_master;
+};
+
+/** Time every block of a scenario over the given duration of audio,
+    after a short warm-up.
+*/
+static ScenarioResult timeScenario(const char* name, Scenario& sc, size_t voices, size_t v, double seconds)
+{
+    typedef std::chrono::steady_clock Clock;
+    size_t blocks = (size_t)(seconds * def_sr / v) + 1;
+    for (size_t b = 0; b < blocks / 10 + 1; b++) sc.block();
+
+    std::vector<double> ns(blocks);
+    for (size_t b = 0; b < blocks; b++)
+    {
+        Clock::time_point t0 = Clock::now();
+#ifdef KIWIWAVES_TRACE
+        Trace::Block span(name);
+#endif
+        sc.block();
+        ns[b] = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    }
+    return summarise(name, voices, v, def_sr, ns);
+}
+
+template <class T>
+static void run(std::vector<ScenarioResult>& results, const Options& opt, const char* name)
+{
+    if (opt.filter != nullptr && std::strstr(name, opt.filter) == nullptr)
+        return;
+
+    for (size_t voices : { 1, 8, 32, 128 })
+        for (size_t v : { 32, 64, 256, 1024 })
+        {
+            T sc(voices, v);
+            results.push_back(timeScenario(name, sc, voices, v, opt.seconds));
+            const ScenarioResult& r = results.back();
+            std::fprintf(stderr, "%-10s %4zu voices %5zu vsize  rtf %7.4f  p50 %9.2f us  p99 %9.2f us  max %9.2f us  (deadline %8.2f us)\n",
+                name, voices, v, r.rtf, r.p50Us, r.p99Us, r.maxUs, r.deadlineUs);
+        }
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    const char* out = nullptr;
+#ifdef KIWIWAVES_TRACE
+    const char* trace = nullptr;
+#endif
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) opt.filter = argv[++i];
+        else if (std::strcmp(argv[i], "--quick") == 0) opt.seconds = 0.25;
+#ifdef KIWIWAVES_TRACE
+        else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace = argv[++i];
+#endif
+        else if (argv[i][0] != '-') out = argv[i];
+        else
+        {
+            std::fprintf(stderr, "usage: kiwiwaves_scenarios [--filter name] [--quick] [--trace trace.json] [output.json]\n");
+            return 1;
+        }
+    }
+
+    std::vector<ScenarioResult> results;
+    run<Poly>(results, opt, "poly");
+    run<Flanger>(results, opt, "flanger");
+    run<CombBank>(results, opt, "combbank");
+    run<Mastering>(results, opt, "mastering");
+
+#ifdef KIWIWAVES_TRACE
+    // The rings keep the last blocks of the last runs
+    if (trace != nullptr)
+    {
+        std::ofstream file(trace);
+        Trace::write(file);
+    }
+#endif
+
+    if (out != nullptr)
+    {
+        std::ofstream file(out);
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", out);
+            return 1;
+        }
+        writeJson(file, "kiwiwaves_scenarios", results);
+    }
+    else
+        writeJson(std::cout, "kiwiwaves_scenarios", results);
+
+    return 0;
+}
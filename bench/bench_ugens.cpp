@@ -0,0 +1,156 @@
+////////////////////////////////////////////////////////////////////
+// kiwiwaves_bench: per-UGen micro-benchmarks
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "BenchUtil.h"
+#include "Phasor.h"
+#include "Osc.h"
+#include "TableRead.h"
+#include "FuncTab.h"
+#include "Butterworth.h"
+#include "Reson.h"
+#include "Tone.h"
+#include "Delay.h"
+#include "Comb.h"
+#include "SegmentEnv.h"
+#include "Rms.h"
+#include "Balance.h"
+#include "Static.h"
+#include "FastMath.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Bench;
+
+struct Options
+{
+    const char* filter = nullptr;
+    double minMs = 20.;
+};
+
+static void run(std::vector<Result>& results, const Options& opt, const char* ugen, const char* variant, UGen& u)
+{
+    if (opt.filter != nullptr && std::strstr(ugen, opt.filter) == nullptr)
+        return;
+
+    results.push_back(measure(ugen, variant, u, opt.minMs));
+    const Result& r = results.back();
+    std::fprintf(stderr, "%-12s %-12s %5zu %9.2f ns/sample %8.1f Msamples/s\n",
+        ugen, variant, r.vsize, r.nsPerSample, r.samplesPerSec * 1e-6);
+}
+
+static void benchVsize(size_t v, std::vector<Result>& res, const Options& opt)
+{
+    // Static inputs and modulators, so only the UGen under test is timed
+    Signal noise(v, 0., 0., 0., 1.), freq(v, 200., 2000., 0.5), index(v, 0., 1., 1.);
+    Signal cut(v, 500., 5000., 0.5), band(v, 50., 500., 0.5), del(v, 0.001, 0.009, 0.5), fb(v, 0.2, 0.8, 0.5);
+    SinTab sine;
+
+    { Phasor u(440., 0., v); run(res, opt, "Phasor", "fixed", u); }
+    { Phasor u(freq, 0., v); run(res, opt, "Phasor", "modulated", u); }
+
+    { Osc u(1., 440., sine, 0., 0., v); run(res, opt, "Osc", "fixed", u); }
+    { Osc u(1., freq, sine, 0., 0., v); run(res, opt, "Osc", "modulated", u); }
+    { OscI u(1., 440., sine, 0., 0., v); run(res, opt, "OscI", "fixed", u); }
+    { OscI u(1., freq, sine, 0., 0., v); run(res, opt, "OscI", "modulated", u); }
+    { OscC u(1., 440., sine, 0., 0., v); run(res, opt, "OscC", "fixed", u); }
+    { OscC u(1., freq, sine, 0., 0., v); run(res, opt, "OscC", "modulated", u); }
+
+    double idx = 0.3;
+    { TableRead u(idx, sine, true, true, v); run(res, opt, "TableRead", "fixed", u); }
+    { TableRead u(index, sine, true, true, v); run(res, opt, "TableRead", "modulated", u); }
+    { TableReadI u(idx, sine, true, true, v); run(res, opt, "TableReadI", "fixed", u); }
+    { TableReadI u(index, sine, true, true, v); run(res, opt, "TableReadI", "modulated", u); }
+    { TableReadC u(idx, sine, true, true, v); run(res, opt, "TableReadC", "fixed", u); }
+    { TableReadC u(index, sine, true, true, v); run(res, opt, "TableReadC", "modulated", u); }
+
+    { LowP u(noise, 1000., v); run(res, opt, "LowP", "fixed", u); }
+    { LowP u(noise, cut, v); run(res, opt, "LowP", "modulated", u); }
+    { HighP u(noise, 1000., v); run(res, opt, "HighP", "fixed", u); }
+    { HighP u(noise, cut, v); run(res, opt, "HighP", "modulated", u); }
+    { BandP u(noise, 1000., 100., v); run(res, opt, "BandP", "fixed", u); }
+    { BandP u(noise, cut, band, v); run(res, opt, "BandP", "modulated", u); }
+    { BandR u(noise, 1000., 100., v); run(res, opt, "BandR", "fixed", u); }
+    { BandR u(noise, cut, band, v); run(res, opt, "BandR", "modulated", u); }
+
+    { ResonR u(noise, 1000., 100., v); run(res, opt, "ResonR", "fixed", u); }
+    { ResonR u(noise, cut, band, v); run(res, opt, "ResonR", "modulated", u); }
+    setMathPrecision(fastMath);
+    { ResonR u(noise, cut, band, v); run(res, opt, "ResonR", "mod fast", u); }
+    setMathPrecision(preciseMath);
+    { Reson u(noise, 1000., 100., v); run(res, opt, "Reson", "fixed", u); }
+    { Reson u(noise, cut, band, v); run(res, opt, "Reson", "modulated", u); }
+    { ResonZ u(noise, 1000., 100., v); run(res, opt, "ResonZ", "fixed", u); }
+    { ResonZ u(noise, cut, band, v); run(res, opt, "ResonZ", "modulated", u); }
+
+    { ToneLP u(noise, 1000., v); run(res, opt, "ToneLP", "fixed", u); }
+    { ToneLP u(noise, cut, v); run(res, opt, "ToneLP", "modulated", u); }
+    { ToneHP u(noise, 1000., v); run(res, opt, "ToneHP", "fixed", u); }
+    { ToneHP u(noise, cut, v); run(res, opt, "ToneHP", "modulated", u); }
+
+    { Delay u(noise, 0.01, 0.005, 0.5, false, v); run(res, opt, "Delay", "fixed", u); }
+    { Delay u(noise, 0.01, del, fb, true, v); run(res, opt, "Delay", "modulated", u); }
+    { Comb u(noise, 1., 0.01, 0.005, false, v); run(res, opt, "Comb", "fixed", u); }
+    { Comb u(noise, 1., 0.01, del, true, v); run(res, opt, "Comb", "modulated", u); }
+
+    // Segments long enough not to reach the final hold while timing
+    { SegmentEnv u({ 0., 1., 0.5, 0. }, { 1e5, 1e5, 1e5 }, linear, 0., false, v); run(res, opt, "SegmentEnv", "linear", u); }
+    { SegmentEnv u({ 0.001, 1., 0.5, 0.001 }, { 1e5, 1e5, 1e5 }, exponential, 0., false, v); run(res, opt, "SegmentEnv", "exponential", u); }
+
+    { Rms u(noise, 10., v); run(res, opt, "Rms", "fixed", u); }
+    { Rms u(noise, cut, v); run(res, opt, "Rms", "modulated", u); }
+    { Balance u(noise, freq, 10., addSmallNumber, v); run(res, opt, "Balance", "fixed", u); }
+    { Balance u(noise, freq, cut, addSmallNumber, v); run(res, opt, "Balance", "modulated", u); }
+
+    // The same chain through the dynamic UGens and as one static kernel
+    { OscI o(1., 440., sine, 0., 0., v); LowP u(o, 1000., v); run(res, opt, "OscI>LowP", "dynamic", u); }
+    { auto u = Static::pipeline(Static::lowP(Static::oscI(1., 440., sine), 1000.), v); run(res, opt, "OscI>LowP", "static", u); }
+    { OscI o(1., freq, sine, 0., 0., v); LowP u(o, cut, v); run(res, opt, "OscI>LowP", "modulated", u); }
+    { auto u = Static::pipeline(Static::lowP(Static::oscI(1., freq, sine), cut), v); run(res, opt, "OscI>LowP", "static mod", u); }
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    const char* out = nullptr;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) opt.filter = argv[++i];
+        else if (std::strcmp(argv[i], "--quick") == 0) opt.minMs = 2.;
+        else if (argv[i][0] != '-') out = argv[i];
+        else
+        {
+            std::fprintf(stderr, "usage: kiwiwaves_bench [--filter name] [--quick] [output.json]\n");
+            return 1;
+        }
+    }
+
+    std::vector<Result> results;
+    for (size_t v : { 16, 64, 256, 1024 })
+        benchVsize(v, results, opt);
+
+    if (out != nullptr)
+    {
+        std::ofstream file(out);
+        if (!file)
+        {
+            std::fprintf(stderr, "cannot write %s\n", out);
+            return 1;
+        }
+        writeJson(file, "kiwiwaves_bench", results);
+    }
+    else
+        writeJson(std::cout, "kiwiwaves_bench", results);
+
+    return 0;
+}
@@ -18,6 +18,8 @@ namespace KiwiWaves
 {
 
 /** Balance the RMS amp of a signal with a comparator signal.
+	Both RMS estimates are computed together with Rms::processPair(),
+	and the zero handling is chosen once per vector.
 */
 class Balance : public UGen
 {
@@ -32,8 +34,11 @@ public:
 	*/
 	Balance(UGen& signalIn, UGen& signalComp, double cutFreq = 10.,
 		ZeroHandlingMode zeroHandling = addSmallNumber, size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_rmsSig(signalIn, cutFreq, vsiz, sr), m_rmsComp(signalComp, cutFreq, vsiz, sr),
-		m_zeroHandling(zeroHandling), UGen(vsiz, sr) { };
+		m_sigIn(signalIn), m_sigComp(signalComp), m_cutFreq(cutFreq), m_zeroHandling(zeroHandling),
+		m_a(0.), m_b(0.), m_freq(0.), m_delSig(0.), m_delComp(0.), m_rmsSig(vsiz), m_rmsComp(vsiz), UGen(vsiz, sr)
+	{
+		ToneLP::coefs(m_freq, m_sr, m_a, m_b);
+	};
 
 	/** Balance constructor. \n
 		signalIn - input audio signal. \n
@@ -45,19 +50,31 @@ public:
 	*/
 	Balance(UGen& signalIn, UGen& signalComp, UGen& cutFreq,
 		ZeroHandlingMode zeroHandling = addSmallNumber, size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_rmsSig(signalIn, cutFreq, vsiz, sr), m_rmsComp(signalComp, cutFreq, vsiz, sr),
-		m_zeroHandling(zeroHandling), UGen(vsiz, sr) { };
+		m_sigIn(signalIn), m_sigComp(signalComp), m_cutFreq(cutFreq), m_zeroHandling(zeroHandling),
+		m_a(0.), m_b(0.), m_freq(0.), m_delSig(0.), m_delComp(0.), m_rmsSig(vsiz), m_rmsComp(vsiz), UGen(vsiz, sr)
+	{
+		ToneLP::coefs(m_freq, m_sr, m_a, m_b);
+	};
 
-	void setCutFreq(double val) { m_rmsSig.setCutFreq(val); m_rmsComp.setCutFreq(val); }
-	void setCutFreq(UGen& modulator) { m_rmsSig.setCutFreq(modulator); m_rmsComp.setCutFreq(modulator); }
+	void setCutFreq(double val) { m_cutFreq.set(val); }
+	void setCutFreq(UGen& modulator) { m_cutFreq.set(modulator); }
 
 protected:
 	void dsp() override;
 
 private:
 	UGen& m_sigIn;
-	Rms m_rmsSig, m_rmsComp;
+	UGen& m_sigComp;
+	UGenParam m_cutFreq;
 	ZeroHandlingMode m_zeroHandling;
+	double m_a, m_b, m_freq, m_delSig, m_delComp;
+	std::vector<double> m_rmsSig, m_rmsComp;
+
+	/** Apply the balancing gain to a vector. \n
+		mode - how to handle a division by zero.
+	*/
+	template <ZeroHandlingMode mode>
+	void applyGain();
 };
 
 }
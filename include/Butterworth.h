@@ -12,7 +12,9 @@
 /////////////////////////////////////////////////////////////////////
 #ifndef _BUTTERWORTH_H_
 #define _BUTTERWORTH_H_
+#include <memory>
 #include "Iir.h"
+#include "CoefTable.h"
 
 namespace KiwiWaves
 {
@@ -50,12 +52,33 @@ public:
 	void setCutFreq(double val) { m_cutFreq.set(val); }
 	void setCutFreq(UGen& modulator) { m_cutFreq.set(modulator); }
 
+	/** Compute the low-pass coefficients. \n
+		freq - cutoff frequency. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2).
+	*/
+	static void coefs(double freq, double sr, double* a, double* b);
+
+	/** Read the coefficients from a table shared by all the filters of the
+		same type and sampling rate instead of computing them on every
+		parameter change. Coefficients are then interpolated, which is
+		much cheaper under heavy modulation but slightly less accurate. \n
+		use - enable or disable the table.
+	*/
+	void useCoefTable(bool use);
+
 protected:
 	double m_freq;
 	UGenParam m_cutFreq;
+	std::shared_ptr<const CoefTable> m_coefTab;
 
 	void update() override;
 	virtual bool prepareUpdate(const size_t& indx) override;
+
+	/** Get the filter design, used to select the coefficient table.
+	*/
+	virtual FilterDesign design() const { return lowPassDesign; }
 };
 
 /** 2nd-order Butterworth high-pass filter.
@@ -88,8 +111,17 @@ public:
 		update();
 	};
 
+	/** Compute the high-pass coefficients. \n
+		freq - cutoff frequency. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2).
+	*/
+	static void coefs(double freq, double sr, double* a, double* b);
+
 protected:
 	void update() override;
+	FilterDesign design() const override { return highPassDesign; }
 };
 
 /** 2nd-order Butterworth band-pass filter.
@@ -153,11 +185,21 @@ public:
 	void setBand(double val) { m_band.set(val); }
 	void setBand(UGen& modulator) { m_band.set(modulator); }
 
+	/** Compute the band-pass coefficients. \n
+		freq - center frequency. \n
+		band - bandwidth. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2).
+	*/
+	static void coefs(double freq, double band, double sr, double* a, double* b);
+
 protected:
 	double m_bw;
 
 	virtual bool prepareUpdate(const size_t& indx) override;
 	void update() override;
+	FilterDesign design() const override { return bandPassDesign; }
 
 private:
 	UGenParam m_band;
@@ -221,8 +263,18 @@ public:
 		update();
 	};
 
+	/** Compute the band-reject coefficients. \n
+		freq - center frequency. \n
+		band - bandwidth. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2).
+	*/
+	static void coefs(double freq, double band, double sr, double* a, double* b);
+
 protected:
 	void update() override;
+	FilterDesign design() const override { return bandRejectDesign; }
 };
 
 }
@@ -0,0 +1,84 @@
+/////////////////////////////////////////////////////////////////////
+// CoefTable class: shared tables of filter coefficients
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _COEFTABLE_H_
+#define _COEFTABLE_H_
+#include <memory>
+#include <vector>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Table of precomputed 2nd-order filter coefficients, indexed by
+	normalized frequency and bandwidth and read with bilinear interpolation.
+	Both axes are square-root warped to give more resolution to low values.
+	Filters with the same design and sampling rate share a single table.
+*/
+class CoefTable
+{
+public:
+	/** Coefficient design function. \n
+		freq - center or cutoff frequency. \n
+		band - bandwidth. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2). \n
+		scal - output input scaling.
+	*/
+	typedef void (*Design)(double freq, double band, double sr, double* a, double* b, double& scal);
+
+	/** CoefTable constructor. \n
+		design - coefficient design function. \n
+		useBand - the design depends on the bandwidth. \n
+		sr - sampling rate. \n
+		fsiz - number of points in the frequency axis. \n
+		bsiz - number of points in the bandwidth axis.
+	*/
+	CoefTable(Design design, bool useBand, double sr, size_t fsiz = def_coef_fsize, size_t bsiz = def_coef_bsize);
+
+	/** Get the table shared by all the filters of a design at a sampling rate,
+		creating it if needed. \n
+		design - filter design. \n
+		sr - sampling rate.
+	*/
+	static std::shared_ptr<const CoefTable> get(FilterDesign design, double sr);
+
+	/** Interpolate the coefficients of a filter. \n
+		freq - center or cutoff frequency. \n
+		band - bandwidth (ignored if the design does not use it). \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2). \n
+		scal - output input scaling.
+	*/
+	void lookup(double freq, double band, double* a, double* b, double& scal) const;
+
+	/** Get the sampling rate.
+	*/
+	const double& sr() const { return m_sr; }
+
+private:
+	std::vector<double> m_coefs;
+	size_t m_fsiz, m_bsiz;
+	double m_sr, m_twoInvSr;
+
+	/** Get the warped table position of a frequency. \n
+		freq - frequency. \n
+		siz - number of points in the axis. \n
+		pos - output integer position. \n
+		frac - output fractional part.
+	*/
+	void position(double freq, size_t siz, size_t& pos, double& frac) const;
+};
+
+}
+
+#endif
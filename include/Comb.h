@@ -76,9 +76,16 @@ public:
 		size_t vsiz = def_vsize, double sr = def_sr) :
 		m_currentRT60(-1.), m_currentDel(-1.), m_currentFb(-1.),
 		Delay(signalIn, maxDel, del, rt60, interpolate, vsiz, sr) { };
+
+	/** Get the feedback gain that makes a delay decay by 60 dB in rt60. \n
+		del - delay time. \n
+		rt60 - reverberation time 60.
+	*/
+	static double fbFromRT60(double del, double rt60);
 	
 private:
 	double m_currentRT60, m_currentDel, m_currentFb;
+	bool gainFb() const override { return false; }
 	double getFb(size_t pos) override;
 };
 
@@ -0,0 +1,115 @@
+/////////////////////////////////////////////////////////////////////
+// Convolver class: partitioned FFT convolution
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _CONVOLVER_H_
+#define _CONVOLVER_H_
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "UGen.h"
+#include "FuncTab.h"
+#include "Fft.h"
+
+namespace KiwiWaves
+{
+
+/** Convolution with an impulse response, for reverbs and long FIR filters.
+	The impulse response is split in partitions of the same size,
+	and each of them is convolved in the frequency domain against a delay
+	line of input spectra (uniformly partitioned overlap-save). \n
+	The partition size does not depend on the vector size. The output is
+	delayed by one partition, unless zero latency is requested: the first
+	partition is then convolved directly in the time domain.
+*/
+class Convolver : public UGen
+{
+public:
+	/** Convolver constructor. \n
+		signalIn - input audio signal. \n
+		ir - impulse response table. \n
+		irLen - number of samples of the table to use (0 for the whole table). \n
+		zeroLatency - convolve the first partition in the time domain. \n
+		bsiz - partition size, rounded up to a power of two. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	Convolver(UGen& signalIn, const FuncTab& ir, size_t irLen = 0, bool zeroLatency = false,
+		size_t bsiz = def_conv_bsize, size_t vsiz = def_vsize, double sr = def_sr);
+
+	/** Destructor, waits for any impulse response being prepared.
+	*/
+	~Convolver();
+
+	/** Replace the impulse response. The partitions are prepared, on a
+		background thread if async, and the new response is swapped in at
+		the start of the next vector processed after that. The tail
+		of the previous response is cut. \n
+		ir - impulse response table. \n
+		irLen - number of samples of the table to use (0 for the whole table). \n
+		async - prepare the partitions on a background thread.
+	*/
+	void setIR(const FuncTab& ir, size_t irLen = 0, bool async = true);
+
+	/** True while a new impulse response has not been swapped in yet.
+	*/
+	bool loading() const { return m_pending.load() != nullptr || m_preparing.load(); }
+
+	/** Get the latency in samples.
+	*/
+	size_t latency() const { return m_zeroLat ? 0 : m_block; }
+
+	/** Get the partition size.
+	*/
+	size_t blockSize() const { return m_block; }
+
+protected:
+	void dsp() override;
+
+private:
+	/** Prepared impulse response with its delay line of input spectra.
+	*/
+	struct Kernel
+	{
+		std::vector<double> head;
+		std::vector<double> re, im;
+		std::vector<double> fdlRe, fdlIm;
+		size_t parts;
+	};
+
+	UGen& m_sigIn;
+	size_t m_block;
+	bool m_zeroLat;
+	Fft m_fft;
+
+	std::unique_ptr<Kernel> m_kernel;
+	std::atomic<Kernel*> m_pending, m_retired;
+	std::atomic<bool> m_preparing;
+	std::thread m_loader;
+
+	std::vector<double> m_inBuf, m_outBuf, m_time, m_accRe, m_accIm, m_hist;
+	size_t m_fill, m_fdlPos;
+
+	/** Split an impulse response in partitions and get their spectra. \n
+		ir - impulse response. \n
+		bsiz - partition size. \n
+		zeroLatency - keep the first partition in the time domain.
+	*/
+	static Kernel* prepare(const std::vector<double>& ir, size_t bsiz, bool zeroLatency);
+
+	/** Convolve the last complete partition of input.
+	*/
+	void partition();
+};
+
+}
+
+#endif
@@ -33,10 +33,12 @@ public:
 	*/
 	Delay(UGen& signalIn, double maxDel, double del = -1., double feedback = 0., bool interpolate = false,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_delVal(del != -1 ? del : maxDel), m_delLine(maxDel >= 0. ? (size_t)std::ceil((maxDel * sr)) : 1),
+		m_sigIn(signalIn), m_delVal(del != -1 ? del : maxDel), m_delLine(lineSize(maxDel, sr)),
+		m_maxDel(maxDel >= 0. ? std::ceil(maxDel * sr) : 1.),
 		m_fb(feedback), m_interp(interpolate), m_writePos(0), UGen(vsiz, sr)
 	{
 		std::fill(m_delLine.begin(), m_delLine.end(), 0.);
+		m_mask = m_delLine.size() - 1;
 	};
 
 	/** Delay constructor. \n
@@ -50,10 +52,12 @@ public:
 	*/
 	Delay(UGen& signalIn, double maxDel, UGen& del, double feedback = 0., bool interpolate = true,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_delVal(del), m_delLine(maxDel >= 0. ? (size_t)std::ceil((maxDel * sr)) : 1),
+		m_sigIn(signalIn), m_delVal(del), m_delLine(lineSize(maxDel, sr)),
+		m_maxDel(maxDel >= 0. ? std::ceil(maxDel * sr) : 1.),
 		m_fb(feedback), m_interp(interpolate), m_writePos(0), UGen(vsiz, sr)
 	{
 		std::fill(m_delLine.begin(), m_delLine.end(), 0.);
+		m_mask = m_delLine.size() - 1;
 	};
 
 	/** Delay constructor. \n
@@ -67,10 +71,12 @@ public:
 	*/
 	Delay(UGen& signalIn, double maxDel, double del, UGen& feedback, bool interpolate = false,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_delVal(del != -1 ? del : maxDel), m_delLine(maxDel >= 0. ? (size_t)std::ceil((maxDel * sr)) : 1),
+		m_sigIn(signalIn), m_delVal(del != -1 ? del : maxDel), m_delLine(lineSize(maxDel, sr)),
+		m_maxDel(maxDel >= 0. ? std::ceil(maxDel * sr) : 1.),
 		m_fb(feedback), m_interp(interpolate), m_writePos(0), UGen(vsiz, sr)
 	{
 		std::fill(m_delLine.begin(), m_delLine.end(), 0.);
+		m_mask = m_delLine.size() - 1;
 	};
 
 	/** Delay constructor. \n
@@ -84,10 +90,12 @@ public:
 	*/
 	Delay(UGen& signalIn, double maxDel, UGen& del, UGen& feedback, bool interpolate = true,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		m_sigIn(signalIn), m_delVal(del), m_delLine(maxDel >= 0. ? (size_t)std::ceil((maxDel * sr)) : 1),
+		m_sigIn(signalIn), m_delVal(del), m_delLine(lineSize(maxDel, sr)),
+		m_maxDel(maxDel >= 0. ? std::ceil(maxDel * sr) : 1.),
 		m_fb(feedback), m_interp(interpolate), m_writePos(0), UGen(vsiz, sr)
 	{
 		std::fill(m_delLine.begin(), m_delLine.end(), 0.);
+		m_mask = m_delLine.size() - 1;
 	};
 
 	void setDel(double val) { m_delVal.set(val); }
@@ -103,9 +111,22 @@ public:
 	size_t getWritePos() const { return m_writePos; }
 
 	/** Get the current state of the delay line.
+		Its length is rounded up to a power of two.
 	*/
 	const std::vector<double>& getDelayline() const { return m_delLine; }
 
+	/** Get the length of a delay line that can hold a delay,
+		rounded up to a power of two. \n
+		maxDel - max value of delay. \n
+		sr - sampling rate.
+	*/
+	static size_t lineSize(double maxDel, double sr)
+	{
+		size_t n = maxDel >= 0. ? (size_t)std::ceil(maxDel * sr) : 1, siz = 1;
+		while (siz < n) siz <<= 1;
+		return siz;
+	}
+
 protected:
 	UGenParam m_delVal;
 	UGenParam m_fb;
@@ -115,8 +136,32 @@ protected:
 private:
 	UGen& m_sigIn;
 	std::vector<double> m_delLine;
+	double m_maxDel;
 	bool m_interp;
-	size_t m_writePos;
+	size_t m_writePos, m_mask;
+
+	/** Process a block with a fixed delay of at least one block,
+		reading and writing the delay line as whole spans. \n
+		readOffs - integer read offset behind the write position. \n
+		frac - interpolation fraction towards the next sample.
+	*/
+	void dspFixed(size_t readOffs, double frac);
+
+	/** Process a block sample by sample, for delays shorter than a block
+		or modulated. The modulation of the delay and the kind of feedback
+		are set once per block. \n
+		modDel - the delay is modulated, read sample by sample. \n
+		gain - the feedback is m_fb times the output, read as a block
+		instead of through getFb(). \n
+		del - values of the delay.
+	*/
+	template <bool modDel, bool gain>
+	void dspSamples(UGenParam::Block del);
+
+	/** True if m_fb holds the feedback gain itself, as getFb() of Delay
+		reads it, false if a subclass computes the feedback in getFb().
+	*/
+	virtual bool gainFb() const { return true; }
 
 	/** Get the corresponding sample of feedback on the position of the audio vector.
 	*/
@@ -0,0 +1,76 @@
+/////////////////////////////////////////////////////////////////////
+// Denormals: flush-to-zero mode and flushing of decaying state
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _DENORMALS_H_
+#define _DENORMALS_H_
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Flush a value of a recursive state or of a feedback path to zero once it
+	has decayed below denormal_threshold. \n
+	The recursive UGens flush their state at the end of every vector, and
+	the delay lines flush their feedback as it is written, so that a tail
+	fading into silence reaches exact zeros instead of denormal numbers,
+	which are 10 to 100 times slower to compute on most CPUs.
+*/
+inline double flushDenormal(double x)
+{
+	return std::fabs(x) < denormal_threshold ? 0. : x;
+}
+
+/** Flush the n values of a state array.
+*/
+inline void flushDenormals(double* x, size_t n)
+{
+	for (size_t i = 0; i < n; i++)
+		x[i] = flushDenormal(x[i]);
+}
+
+/** Flush-to-zero mode of the calling thread while in scope: denormal
+	results are replaced by zero (FTZ) and denormal operands are read as
+	zero (DAZ). It covers the denormals that appear within a vector,
+	before the UGens flush their state, so put one around the processing
+	of a graph, in the audio callback. The previous mode is restored on
+	destruction. \n
+	The mode is set through MXCSR on x86 (SSE math) and FPCR on AArch64,
+	and the scope does nothing on other targets.
+*/
+class DenormalScope
+{
+public:
+	/** DenormalScope constructor. \n
+		enable - false leaves the mode of the thread unchanged.
+	*/
+	DenormalScope(bool enable = true);
+
+	/** Restore the previous mode.
+	*/
+	~DenormalScope();
+
+	/** True if the flush-to-zero mode is on in the calling thread.
+	*/
+	static bool active();
+
+private:
+	DenormalScope(const DenormalScope&) = delete;
+	DenormalScope& operator=(const DenormalScope&) = delete;
+
+	bool m_enabled;
+	uint64_t m_saved;
+};
+
+}
+#endif
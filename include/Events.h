@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////
+// EventQueue class: sample-accurate timestamped events
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _EVENTS_H_
+#define _EVENTS_H_
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Event at a sample offset from the start of the next vector.
+*/
+struct Event
+{
+	size_t offset;
+	EventType type;
+	double value;
+};
+
+/** Fixed-capacity queue of events sorted by sample offset, for UGens
+	that split their processing at the events. Events at the same offset
+	keep the order in which they were pushed. Offsets past the end of a
+	vector carry over to the following vectors. \n
+	The queue does not allocate, so events can be pushed from the
+	audio thread between process() calls.
+*/
+class EventQueue
+{
+public:
+	/** EventQueue constructor.
+	*/
+	EventQueue() : m_size(0) { };
+
+	/** Add an event, false if the queue is full. \n
+		offset - sample offset from the start of the next vector. \n
+		type - kind of event. \n
+		value - event parameter.
+	*/
+	bool push(size_t offset, EventType type, double value = 0.);
+
+	/** Get the offset of the first event, or n if there is none before n. \n
+		n - end of the span being processed.
+	*/
+	size_t next(size_t n) const { return m_size > 0 && m_events[0].offset < n ? m_events[0].offset : n; }
+
+	/** Get the first event.
+	*/
+	const Event& front() const { return m_events[0]; }
+
+	/** Remove the first event.
+	*/
+	void pop();
+
+	/** Move on to the next vector, the offsets are reduced by n. \n
+		n - number of frames of the vector just processed.
+	*/
+	void advance(size_t n);
+
+	/** Remove all the events.
+	*/
+	void clear() { m_size = 0; }
+
+	/** Get the number of events waiting.
+	*/
+	size_t size() const { return m_size; }
+
+	/** True if no event is waiting.
+	*/
+	bool empty() const { return m_size == 0; }
+
+private:
+	Event m_events[def_event_capacity];
+	size_t m_size;
+};
+
+}
+
+#endif
@@ -0,0 +1,280 @@
+/////////////////////////////////////////////////////////////////////
+// FastMath: fast approximations of elementary functions
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _FASTMATH_H_
+#define _FASTMATH_H_
+#include <cstring>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Fast approximations of elementary functions, accurate to about
+	1e-12. The scalar versions are inline and mostly branch-free, so
+	that loops calling them can be vectorized, and the block versions
+	apply them to whole arrays. One scalar call is about as fast as the
+	standard library, so the gain is in the vectorized block loops.
+	Error bounds are given against the exact result.
+*/
+namespace FastMath
+{
+	/** Round to the nearest integer, valid for |x| < 2^51.
+	*/
+	inline double round(double x)
+	{
+		const double magic = 6755399441055744.; // 1.5 * 2^52
+		return (x + magic) - magic;
+	}
+
+	/** Get 2^k for an integer-valued k in [-1022, 1023].
+	*/
+	inline double pow2(double k)
+	{
+		// Adding the rounding constant leaves k in the low bits of the mantissa
+		double kb = k + 6755399441055744.;
+		uint64_t bits;
+		std::memcpy(&bits, &kb, sizeof(bits));
+		bits = (bits - 0x4338000000000000ULL + 1023) << 52;
+		double s;
+		std::memcpy(&s, &bits, sizeof(s));
+		return s;
+	}
+
+	/** Sine and cosine of the reduced argument |r| <= pi/4, from
+		near-minimax polynomials in r^2 evaluated in Estrin form,
+		so that the two halves of each polynomial run in parallel.
+	*/
+	inline void sinCosReduced(double r, double& s, double& c)
+	{
+		double z = r * r, z2 = z * z, z4 = z2 * z2;
+		double ps = (-1.6666666666663885e-01 + z * 8.3333333310792230e-03) +
+			z2 * (-1.9841266916985966e-04 + z * 2.7555990929565320e-06) + z4 * -2.4805636241834762e-08;
+		double pc = (-4.9999999999963890e-01 + z * 4.1666666637396070e-02) +
+			z2 * (-1.3888885091399200e-03 + z * 2.4799862190148396e-05) + z4 * -2.7237140418016000e-07;
+		s = r + r * z * ps;
+		c = 1. + z * pc;
+	}
+
+	/** Reduce x to r = x - q * pi/2, |r| <= pi/4,
+		returning the quadrant q mod 4 (0., 1., 2. or 3.).
+	*/
+	inline double reduce(double x, double& r)
+	{
+		const double pio2_1 = 1.57079632673412561417e+00;
+		const double pio2_2 = 6.07710050650619224932e-11;
+		double q = round(x * 0.63661977236758134308); // 2/pi
+		r = (x - q * pio2_1) - q * pio2_2;
+		return q - 4. * round((q - 1.5) * 0.25);
+	}
+
+	/** Sine. Absolute error below 1e-12 for |x| < 1e5.
+	*/
+	inline double sin(double x)
+	{
+		double r, s, c;
+		double q = reduce(x, r);
+		sinCosReduced(r, s, c);
+		bool odd = (q == 1.) | (q == 3.);
+		double v = odd ? c : s;
+		return v * ((q == 2.) | (q == 3.) ? -1. : 1.);
+	}
+
+	/** Cosine. Absolute error below 1e-12 for |x| < 1e5.
+	*/
+	inline double cos(double x)
+	{
+		double r, s, c;
+		double q = reduce(x, r);
+		sinCosReduced(r, s, c);
+		bool odd = (q == 1.) | (q == 3.);
+		double v = odd ? s : c;
+		return v * ((q == 1.) | (q == 2.) ? -1. : 1.);
+	}
+
+	/** Tangent. Relative error below 1e-12 for |x| < 1e5.
+	*/
+	inline double tan(double x)
+	{
+		double r, s, c;
+		double q = reduce(x, r);
+		sinCosReduced(r, s, c);
+		bool odd = (q == 1.) | (q == 3.);
+		double num = odd ? c : s;
+		double den = odd ? s : c;
+		return (odd ? -1. : 1.) * num / den;
+	}
+
+	/** Exponential. Relative error below 1e-12.
+		The argument is clamped to [-708, 709].
+	*/
+	inline double exp(double x)
+	{
+		const double ln2_hi = 6.93147180369123816490e-01;
+		const double ln2_lo = 1.90821492927058770002e-10;
+		x = x < -708. ? -708. : (x > 709. ? 709. : x);
+		double k = round(x * 1.44269504088896338700); // 1/ln(2)
+		double r = (x - k * ln2_hi) - k * ln2_lo;
+		double r2 = r * r, r4 = r2 * r2;
+		double p = ((4.9999999999955080e-01 + r * 1.6666666666662583e-01) +
+			r2 * (4.1666666786320460e-02 + r * 8.3333333442079540e-03)) +
+			r4 * ((1.3888839095384945e-03 + r * 1.9841224585854810e-04) +
+			r2 * (2.4867880294539510e-05 + r * 2.7617573977657300e-06));
+		return (1. + (r + r2 * p)) * pow2(k);
+	}
+
+	/** Natural logarithm. Absolute error below 1e-12 * (1 + |log(x)|)
+		for positive normal x.
+	*/
+	inline double log(double x)
+	{
+		const double ln2_hi = 6.93147180369123816490e-01;
+		const double ln2_lo = 1.90821492927058770002e-10;
+		uint64_t bits, ebits;
+		std::memcpy(&bits, &x, sizeof(bits));
+
+		// Exponent as a double, read through the mantissa of 2^52
+		ebits = (bits >> 52) | 0x4330000000000000ULL;
+		double e;
+		std::memcpy(&e, &ebits, sizeof(e));
+		e -= 4503599627370496. + 1023.;
+
+		// Mantissa in [1, 2), then moved to [sqrt(2)/2, sqrt(2))
+		bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+		double m;
+		std::memcpy(&m, &bits, sizeof(m));
+		bool big = m > 1.41421356237309504880;
+		m *= big ? 0.5 : 1.;
+		e += big ? 1. : 0.;
+
+		double s = (m - 1.) / (m + 1.);
+		double z = s * s, z2 = z * z, z4 = z2 * z2;
+		double lm = 2. * s * ((9.9999999999997360e-01 + z * 3.3333333339789630e-01) +
+			z2 * (1.9999997445916190e-01 + z * 1.4286083072937864e-01) +
+			z4 * (1.1087124955038745e-01 + z * 9.8040478198765270e-02));
+		return e * ln2_hi + (lm + e * ln2_lo);
+	}
+
+	/** Power. Relative error below 1e-12 * (1 + |y * log(x)|) for positive x
+		and y * log(x) in [-708, 709], the range of exp. Non-positive bases
+		fall back to std::pow.
+	*/
+	inline double pow(double x, double y)
+	{
+		return x > 0. ? exp(y * log(x)) : std::pow(x, y);
+	}
+
+	/** Arc sine of |x| <= 0.5, near-minimax polynomial in x^2.
+	*/
+	inline double asinReduced(double x)
+	{
+		double z = x * x, z2 = z * z, z4 = z2 * z2;
+		double p = ((1.6666666666738633e-01 + z * 7.4999999534297120e-02) +
+			z2 * (4.4642906474584965e-02 + z * 3.0379945210024933e-02)) +
+			z4 * ((2.2412417726695433e-02 + z * 1.6902683886393575e-02) +
+			z2 * (1.6864090273960120e-02 + z * 1.0675063150363097e-03) + z4 * 2.8346745231833330e-02);
+		return x + x * z * p;
+	}
+
+	/** Arc cosine. Absolute error below 1e-12 for |x| <= 1.
+	*/
+	inline double acos(double x)
+	{
+		const double pio2 = 1.57079632679489661923;
+		double ax = x < 0. ? -x : x;
+		bool small = ax <= 0.5;
+
+		// Above 0.5, acos(|x|) = 2 * asin(sqrt((1 - |x|) / 2))
+		double root = std::sqrt((1. - ax) * 0.5);
+		double v = asinReduced(small ? x : root);
+		double a = small ? -1. : (x > 0. ? 2. : -2.);
+		double b = small ? pio2 : (x > 0. ? 0. : 2. * pio2);
+		return a * v + b;
+	}
+
+	/** Arc tangent of |x| <= 2 - sqrt(3), Taylor series.
+	*/
+	inline double atanReduced(double x)
+	{
+		double z = x * x;
+		double p = -1. / 27.;
+		for (int k = 12; k >= 0; k--)
+			p = p * z + (k % 2 ? -1. : 1.) / (2 * k + 1);
+		return x * p;
+	}
+
+	/** Arc tangent of y/x in [-pi, pi]. Absolute error below 1e-15.
+	*/
+	inline double atan2(double y, double x)
+	{
+		const double pio2 = 1.57079632679489661923;
+		const double pio6 = 0.52359877559829887308;
+		const double sqrt3 = 1.73205080756887729353;
+		double ax = x < 0. ? -x : x, ay = y < 0. ? -y : y;
+
+		// Ratio in [0, 1], then moved to [-(2 - sqrt(3)), 2 - sqrt(3)] around tan(pi/6)
+		bool swap = ay > ax;
+		double num = swap ? ax : ay, den = swap ? ay : ax;
+		double a = num / (den > 0. ? den : 1.);
+		bool big = a > 0.26794919243112270647;
+		double t = atanReduced(big ? (a * sqrt3 - 1.) / (a + sqrt3) : a) + (big ? pio6 : 0.);
+
+		t = swap ? pio2 - t : t;
+		t = x < 0. ? 2. * pio2 - t : t;
+		return y < 0. ? -t : t;
+	}
+
+	/** Reciprocal of a positive normal x below 2^1021, from an exponent
+		bit trick refined by three Newton iterations. Relative error below 1e-10.
+	*/
+	inline double recip(double x)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		bits = 0x7fde623822fc16e6ULL - bits;
+		double r;
+		std::memcpy(&r, &bits, sizeof(r));
+		r = r * (2. - x * r);
+		r = r * (2. - x * r);
+		r = r * (2. - x * r);
+		return r;
+	}
+
+	/** Block versions: out[i] = f(in[i]) for i < n.
+	*/
+	void sin(const double* in, double* out, size_t n);
+	void cos(const double* in, double* out, size_t n);
+	void tan(const double* in, double* out, size_t n);
+	void exp(const double* in, double* out, size_t n);
+	void log(const double* in, double* out, size_t n);
+	void acos(const double* in, double* out, size_t n);
+
+	/** Block power: out[i] = pow(in[i], y) for i < n.
+	*/
+	void pow(const double* in, double y, double* out, size_t n);
+
+	/** Block arc tangent: out[i] = atan2(y[i], x[i]) for i < n.
+	*/
+	void atan2(const double* y, const double* x, double* out, size_t n);
+}
+
+/** Select the precision of the math used by the UGens. With fastMath,
+	ResonR computes its input scaling with a square root instead of
+	sin(acos()). It is read once per coefficient update.
+*/
+void setMathPrecision(MathPrecision prec);
+
+/** Get the precision of the math used by the UGens.
+*/
+MathPrecision getMathPrecision();
+
+}
+
+#endif
@@ -0,0 +1,145 @@
+/////////////////////////////////////////////////////////////////////
+// FdnReverb class: feedback delay network reverb
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _FDNREVERB_H_
+#define _FDNREVERB_H_
+#include <vector>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+
+/** Feedback delay network reverb. The delay lines have prime lengths
+	spread geometrically and are stored together in a single buffer.
+	Every line is damped with a ToneLP one-pole and a Comb RT60 gain,
+	and mixed back into the others through an orthogonal matrix. \n
+	The lines are processed as whole spans of up to one vector,
+	so the RT60 and damping frequency are read once per vector.
+*/
+class FdnReverb : public UGen
+{
+public:
+	/** FdnReverb constructor. \n
+		signalIn - input audio signal. \n
+		rt60 - reverberation time 60. \n
+		dampFreq - cutoff frequency of the damping filters. \n
+		lines - number of delay lines (rounded up to a power of two for hadamardMatrix). \n
+		matrix - feedback matrix. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	FdnReverb(UGen& signalIn, double rt60, double dampFreq, size_t lines = def_fdn_lines,
+		FdnMatrix matrix = hadamardMatrix, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_rt60(rt60), m_dampFreq(dampFreq), m_matrix(matrix), UGen(vsiz, sr)
+	{
+		init(lines);
+	};
+
+	/** FdnReverb constructor. \n
+		signalIn - input audio signal. \n
+		rt60 - reverberation time 60. \n
+		dampFreq - cutoff frequency of the damping filters. \n
+		lines - number of delay lines (rounded up to a power of two for hadamardMatrix). \n
+		matrix - feedback matrix. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	FdnReverb(UGen& signalIn, UGen& rt60, double dampFreq, size_t lines = def_fdn_lines,
+		FdnMatrix matrix = hadamardMatrix, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_rt60(rt60), m_dampFreq(dampFreq), m_matrix(matrix), UGen(vsiz, sr)
+	{
+		init(lines);
+	};
+
+	/** FdnReverb constructor. \n
+		signalIn - input audio signal. \n
+		rt60 - reverberation time 60. \n
+		dampFreq - cutoff frequency of the damping filters. \n
+		lines - number of delay lines (rounded up to a power of two for hadamardMatrix). \n
+		matrix - feedback matrix. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	FdnReverb(UGen& signalIn, double rt60, UGen& dampFreq, size_t lines = def_fdn_lines,
+		FdnMatrix matrix = hadamardMatrix, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_rt60(rt60), m_dampFreq(dampFreq), m_matrix(matrix), UGen(vsiz, sr)
+	{
+		init(lines);
+	};
+
+	/** FdnReverb constructor. \n
+		signalIn - input audio signal. \n
+		rt60 - reverberation time 60. \n
+		dampFreq - cutoff frequency of the damping filters. \n
+		lines - number of delay lines (rounded up to a power of two for hadamardMatrix). \n
+		matrix - feedback matrix. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	FdnReverb(UGen& signalIn, UGen& rt60, UGen& dampFreq, size_t lines = def_fdn_lines,
+		FdnMatrix matrix = hadamardMatrix, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_rt60(rt60), m_dampFreq(dampFreq), m_matrix(matrix), UGen(vsiz, sr)
+	{
+		init(lines);
+	};
+
+	void setRT60(double val) { m_rt60.set(val); }
+	void setRT60(UGen& modulator) { m_rt60.set(modulator); }
+
+	void setDampFreq(double val) { m_dampFreq.set(val); }
+	void setDampFreq(UGen& modulator) { m_dampFreq.set(modulator); }
+
+	/** Get the number of delay lines.
+	*/
+	size_t lines() const { return m_len.size(); }
+
+	/** Get the length in samples of a delay line.
+	*/
+	size_t lineLength(size_t line) const { return m_len[line]; }
+
+protected:
+	UGenParam m_rt60;
+	UGenParam m_dampFreq;
+
+	void dsp() override;
+
+private:
+	UGen& m_sigIn;
+	FdnMatrix m_matrix;
+
+	// All the delay lines, one after the other
+	std::vector<double> m_arena;
+	std::vector<size_t> m_offs, m_len, m_pos;
+
+	// Per-line RT60 gains and damping filter states
+	std::vector<double> m_gain, m_damp;
+	double m_a, m_b, m_curRT60, m_curFreq;
+
+	// Line outputs of the current span, one row per line
+	std::vector<double> m_rows;
+	size_t m_span;
+
+	/** Set up the delay lines.
+	*/
+	void init(size_t lines);
+
+	/** Update the gains and damping coefficients if the parameters changed.
+	*/
+	void update(size_t indx);
+
+	/** Mix the rows through the feedback matrix. \n
+		frames - number of frames in the rows.
+	*/
+	void mix(size_t frames);
+};
+
+}
+#endif
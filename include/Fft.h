@@ -0,0 +1,70 @@
+/////////////////////////////////////////////////////////////////////
+// Fft class: real fast Fourier transform
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _FFT_H_
+#define _FFT_H_
+#include <vector>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Real FFT of a power-of-two size, computed as a complex FFT
+	of half the size in radix-4 stages (plus a radix-2 one for odd
+	powers of two). The twiddles of every stage are precomputed in
+	a plan and stored contiguously, so the butterflies run over unit
+	stride arrays. Spectra are stored as separate real and
+	imaginary arrays of size()/2 + 1 bins. \n
+	An Fft uses internal work buffers, so each thread needs its own.
+*/
+class Fft
+{
+public:
+	/** Fft constructor. \n
+		siz - transform size, rounded up to a power of two (at least 4).
+	*/
+	Fft(size_t siz);
+
+	/** Get the transform size.
+	*/
+	size_t size() const { return m_size; }
+
+	/** Forward transform. \n
+		in - size() real samples. \n
+		re - output real parts, size()/2 + 1 bins. \n
+		im - output imaginary parts, size()/2 + 1 bins.
+	*/
+	void forward(const double* in, double* re, double* im);
+
+	/** Inverse transform, scaled so that it undoes forward(). \n
+		re - real parts, size()/2 + 1 bins. \n
+		im - imaginary parts, size()/2 + 1 bins. \n
+		out - output size() real samples.
+	*/
+	void inverse(const double* re, const double* im, double* out);
+
+private:
+	size_t m_size, m_half;
+	std::vector<size_t> m_bitRev;
+	bool m_radix2;
+	std::vector<double> m_twRe, m_twIm; // per radix-4 stage of span h: W^j, W^2j and W^3j, j < h
+	std::vector<double> m_rcos, m_rsin; // real split twiddles, size()/2 of them
+	std::vector<double> m_re, m_im;
+
+	/** In-place complex FFT of size()/2 points, from bit-reversed input. \n
+		sign - exponent sign, -1 forward and 1 inverse.
+	*/
+	void complexFft(double sign);
+};
+
+}
+
+#endif
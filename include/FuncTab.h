@@ -51,6 +51,10 @@ public:
 	*/
 	const size_t size() const { return m_table.size(); }
 
+	/** Get the table values.
+	*/
+	const double* data() const { return m_table.data(); }
+
 protected:
 	/** Normalise the table.
 	*/
@@ -48,6 +48,19 @@ public:
 		update();
 	};
 
+	/** Filter a whole buffer offline, splitting it in chunks that are
+		processed on several threads. The coefficients must stay constant
+		for the whole buffer, so modulated parameters are only read at
+		control rate. The output equals sequential filtering within
+		floating-point tolerance and the filter state continues from the
+		end of the buffer. \n
+		in - input buffer. \n
+		out - output buffer (can be the same as in). \n
+		frames - number of frames in the buffers. \n
+		threads - number of threads (0 to use the hardware concurrency).
+	*/
+	void processOffline(const double* in, double* out, size_t frames, unsigned int threads = 0);
+
 protected:
 	double m_del[2];
 	double m_a[3];
@@ -64,6 +77,21 @@ protected:
 	/** Update filter coefficients.
 	*/
 	virtual void update() {};
+
+	/** Filter a span with the current coefficients, starting from
+		and updating the given state. \n
+		in - input buffer. \n
+		out - output buffer (nullptr to only advance the state). \n
+		frames - number of frames in the buffers. \n
+		del - filter state.
+	*/
+	virtual void filterSpan(const double* in, double* out, size_t frames, double* del) const;
+
+private:
+	/** Get the matrix that advances the filter state
+		a number of frames with no input.
+	*/
+	void statePower(size_t frames, double* mat) const;
 };
 
 }
@@ -0,0 +1,192 @@
+/////////////////////////////////////////////////////////////////////
+// IirMulti class: multichannel second-order filter
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _IIRMULTI_H_
+#define _IIRMULTI_H_
+#include <vector>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+
+/** Multichannel 2nd-order IIR filter section (Direct Form II).
+	The filter state and the coefficients of all channels are stored
+	side by side, so every step of the recursion advances all the
+	channels at once and can be vectorized across them. \n
+	The output vector holds the filtered channels one after the other,
+	each of them frames() samples long.
+*/
+class IirMulti : public UGen
+{
+
+public:
+	/** IirMulti constructor. \n
+		signalsIn - input audio signals, one per channel. \n
+		a - feedforward coefficients list shared by all channels (a0,a1,a2) \n
+		b - feedback coefficients shared by all channels (b1, b2) \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	IirMulti(const std::vector<UGen*>& signalsIn, const double* a, const double* b,
+		size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIns(signalsIn), m_inData(signalsIn.size()), m_frames(vsiz),
+		m_a(3 * signalsIn.size(), 0.), m_b(2 * signalsIn.size(), 0.), m_del(2 * signalsIn.size(), 0.),
+		m_x(signalsIn.size(), 0.), m_y(signalsIn.size(), 0.), UGen(vsiz * signalsIn.size(), sr)
+	{
+		setCoefs(a, b);
+	};
+
+	/** IirMulti constructor with coefficients set to zero. \n
+		signalsIn - input audio signals, one per channel. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	IirMulti(const std::vector<UGen*>& signalsIn, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIns(signalsIn), m_inData(signalsIn.size()), m_frames(vsiz),
+		m_a(3 * signalsIn.size(), 0.), m_b(2 * signalsIn.size(), 0.), m_del(2 * signalsIn.size(), 0.),
+		m_x(signalsIn.size(), 0.), m_y(signalsIn.size(), 0.), UGen(vsiz * signalsIn.size(), sr) { };
+
+	/** Set the same coefficients on every channel. \n
+		a - feedforward coefficients (a0,a1,a2) \n
+		b - feedback coefficients (b1, b2)
+	*/
+	void setCoefs(const double* a, const double* b);
+
+	/** Set the coefficients of a single channel. \n
+		chn - channel index. \n
+		a - feedforward coefficients (a0,a1,a2) \n
+		b - feedback coefficients (b1, b2)
+	*/
+	void setCoefs(size_t chn, const double* a, const double* b);
+
+	/** Get the number of channels.
+	*/
+	size_t nchnls() const { return m_sigIns.size(); }
+
+	/** Get the number of frames of each channel.
+	*/
+	size_t frames() const { return m_frames; }
+
+	/** Get the processed data of a single channel.
+	*/
+	const double* channel(size_t chn) const { return m_s.data() + chn * m_frames; }
+
+protected:
+	std::vector<UGen*> m_sigIns;
+	std::vector<const double*> m_inData;
+	size_t m_frames;
+
+	// Channel-interleaved layout: m_a holds all a0, then all a1, then all a2,
+	// m_b all b1 then all b2 and m_del all z^-1 states then all z^-2 states.
+	std::vector<double> m_a, m_b, m_del;
+	std::vector<double> m_x, m_y;
+
+	void dsp() override;
+
+	/** True if the coefficients need update because some filter parameter has changed.
+	*/
+	virtual bool prepareUpdate(const size_t& /*indx*/) { return false; }
+
+	/** Update filter coefficients.
+	*/
+	virtual void update() {};
+};
+
+/** Multichannel 2nd-order Butterworth low-pass filter.
+*/
+class LowPMulti : public IirMulti
+{
+
+public:
+	/** LowPMulti constructor. \n
+		signalsIn - input audio signals, one per channel. \n
+		cutFreq - cutoff frequency shared by all channels. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	LowPMulti(const std::vector<UGen*>& signalsIn, double cutFreq, size_t vsiz = def_vsize, double sr = def_sr)
+		: m_cutFreq(cutFreq), m_freq(0.), IirMulti(signalsIn, vsiz, sr)
+	{
+		prepareUpdate(0);
+		update();
+	};
+
+	/** LowPMulti constructor. \n
+		signalsIn - input audio signals, one per channel. \n
+		cutFreq - cutoff frequency shared by all channels. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	LowPMulti(const std::vector<UGen*>& signalsIn, UGen& cutFreq, size_t vsiz = def_vsize, double sr = def_sr)
+		: m_cutFreq(cutFreq), m_freq(0.), IirMulti(signalsIn, vsiz, sr)
+	{
+		prepareUpdate(0);
+		update();
+	};
+
+	void setCutFreq(double val) { m_cutFreq.set(val); }
+	void setCutFreq(UGen& modulator) { m_cutFreq.set(modulator); }
+
+	/** Set the cutoff frequency of a single channel.
+		It holds until the shared cutoff frequency changes. \n
+		chn - channel index. \n
+		val - cutoff frequency.
+	*/
+	virtual void setCutFreq(size_t chn, double val);
+
+protected:
+	double m_freq;
+	UGenParam m_cutFreq;
+
+	void update() override;
+	virtual bool prepareUpdate(const size_t& indx) override;
+};
+
+/** Multichannel 2nd-order Butterworth high-pass filter.
+*/
+class HighPMulti : public LowPMulti
+{
+
+public:
+	/** HighPMulti constructor. \n
+		signalsIn - input audio signals, one per channel. \n
+		cutFreq - cutoff frequency shared by all channels. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	HighPMulti(const std::vector<UGen*>& signalsIn, double cutFreq, size_t vsiz = def_vsize, double sr = def_sr)
+		: LowPMulti(signalsIn, cutFreq, vsiz, sr)
+	{
+		update();
+	};
+
+	/** HighPMulti constructor. \n
+		signalsIn - input audio signals, one per channel. \n
+		cutFreq - cutoff frequency shared by all channels. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	HighPMulti(const std::vector<UGen*>& signalsIn, UGen& cutFreq, size_t vsiz = def_vsize, double sr = def_sr)
+		: LowPMulti(signalsIn, cutFreq, vsiz, sr)
+	{
+		update();
+	};
+
+	void setCutFreq(size_t chn, double val) override;
+	using LowPMulti::setCutFreq;
+
+protected:
+	void update() override;
+};
+
+}
+
+#endif
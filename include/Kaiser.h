@@ -0,0 +1,43 @@
+/////////////////////////////////////////////////////////////////////
+// Kaiser: Kaiser window for the FIR filter designs
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _KAISER_H_
+#define _KAISER_H_
+#include <cmath>
+
+namespace KiwiWaves
+{
+
+/** Zero order modified Bessel function of the first kind.
+*/
+inline double besselI0(double x)
+{
+	double sum = 1., term = 1.;
+	for (int k = 1; k < 50; k++)
+	{
+		term *= (x / (2. * k)) * (x / (2. * k));
+		sum += term;
+	}
+	return sum;
+}
+
+/** Kaiser window, 1 at the center and zero outside. \n
+	r - position relative to the half width, in [-1, 1]. \n
+	beta - shape parameter, higher for a lower sidelobe level.
+*/
+inline double kaiser(double r, double beta)
+{
+	return r * r < 1. ? besselI0(beta * std::sqrt(1. - r * r)) / besselI0(beta) : 0.;
+}
+
+}
+
+#endif
@@ -13,6 +13,8 @@
 #define _KIWIWAVES_H_
 #include <cstdint>
 #include <cmath>
+#include <limits>
+#include "KiwiWavesConfig.h"
 
 /** Types of curves for control signals.
  */
@@ -26,6 +28,22 @@ enum ZeroHandlingMode : uint8_t { addSmallNumber, equalToOne };
  */
 enum TimeUnit : uint8_t { seconds, samples };
 
+/** Precision of the math used to compute coefficients and increments.
+ */
+enum MathPrecision : uint8_t { preciseMath, fastMath };
+
+/** Filter designs that can share a coefficient table.
+ */
+enum FilterDesign : uint8_t { lowPassDesign, highPassDesign, bandPassDesign, bandRejectDesign, resonDesign };
+
+/** Feedback matrices of a feedback delay network.
+ */
+enum FdnMatrix : uint8_t { hadamardMatrix, householderMatrix };
+
+/** Kinds of timestamped events.
+ */
+enum EventType : uint8_t { retrigEvent, releaseEvent, resetEvent, setEvent };
+
 /** Default signal vector size.
  */
 const size_t def_vsize = 64;
@@ -34,6 +52,54 @@ const size_t def_vsize = 64;
  */
 const size_t def_tsize = 16384;
 
+/** Default coefficient table size in the frequency axis.
+ */
+const size_t def_coef_fsize = 512;
+
+/** Default coefficient table size in the bandwidth axis.
+ */
+const size_t def_coef_bsize = 128;
+
+/** Default number of delay lines in a feedback delay network.
+ */
+const size_t def_fdn_lines = 8;
+
+/** Default partition size of the convolution.
+ */
+const size_t def_conv_bsize = 256;
+
+/** Default FFT size of spectral processing.
+ */
+const size_t def_fft_size = 1024;
+
+/** Default hop size of spectral processing.
+ */
+const size_t def_hop_size = 256;
+
+/** Default window length of the meters, in seconds.
+ */
+const double def_meter_win = 0.3;
+
+/** Capacity of the event queue of a UGen.
+ */
+const size_t def_event_capacity = 32;
+
+/** Capacity of the event heap of a scheduler.
+ */
+const size_t def_sched_capacity = 4096;
+
+/** Zero crossings on each side of the resampling filter.
+ */
+const size_t def_resamp_zeros = 32;
+
+/** Phases of the resampling filter table.
+ */
+const size_t def_resamp_phases = 256;
+
+/** Capacity of the trace ring of each thread, in events.
+ */
+const size_t def_trace_capacity = 65536;
+
 /** default sample rate.
  */
 const double def_sr = 44100.;
@@ -58,6 +124,11 @@ const double imperceptible_db = 0.00001;
  */
 const double def_exp_curve_offset = 0.1;
 
+/** Magnitude below which the state of the recursive UGens is flushed
+	to zero, -400 dBFS, far above the denormal range.
+ */
+const double denormal_threshold = 1e-20;
+
 /** Smallest positive value for double.
  */
 const double min_double = std::numeric_limits<double>::min();
@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////
+// Meter, RmsMeter and PeakMeter classes: windowed level meters
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _METERS_H_
+#define _METERS_H_
+#include <vector>
+#include <algorithm>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+
+/** Base class of the windowed meters. A meter measures its input over
+	a sliding window at a constant cost per sample, whatever the window
+	length. \n
+	The output is decimated: every vector of input produces ceil(vsiz / decim)
+	readings, taken after each group of decim input samples and after the
+	last sample of the vector. The output vector and rate are set accordingly. \n
+	vsiz has to be the vector size of the input: the input frames past it
+	are not measured, and if the input is shorter the last reading is held.
+*/
+class Meter : public UGen
+{
+protected:
+	/** Protected Meter constructor. \n
+		signalIn - input audio signal. \n
+		winTime - window length in seconds. \n
+		decim - decimation factor of the output. \n
+		vsiz - number of frames in the input vector. \n
+		sr - sampling rate of the input.
+	*/
+	Meter(UGen& signalIn, double winTime, size_t decim, size_t vsiz, double sr) :
+		m_sigIn(signalIn), m_win(winTime * sr >= 1. ? (size_t)(winTime * sr + 0.5) : 1),
+		m_decim(decim > 0 ? decim : 1), m_value(0.),
+		UGen((vsiz + (decim > 0 ? decim : 1) - 1) / (decim > 0 ? decim : 1), sr / (decim > 0 ? decim : 1)) { };
+
+public:
+	/** Get the last reading.
+	*/
+	double value() const { return m_value; }
+
+	/** Get the window length in samples.
+	*/
+	size_t windowSize() const { return m_win; }
+
+	/** Get the decimation factor of the output.
+	*/
+	size_t decimation() const { return m_decim; }
+
+protected:
+	UGen& m_sigIn;
+	size_t m_win, m_decim;
+	double m_value;
+
+	/** Get the number of input frames to measure, never more than the
+		output vector has readings for.
+	*/
+	size_t inputFrames() const { return std::min(m_sigIn.vsize(), m_s.size() * m_decim); }
+
+	/** Hold the last reading on the rest of the output vector, when the
+		input gave fewer, and keep it as the current value. \n
+		readings - number of readings taken.
+	*/
+	void holdLast(size_t readings)
+	{
+		if (readings == 0) return;
+		std::fill(m_s.begin() + readings, m_s.end(), m_s[readings - 1]);
+		m_value = m_s.back();
+	}
+};
+
+/** True RMS over a sliding window. A running sum of squares is updated
+	with every sample and replaced every window by a sum of the same
+	samples accumulated from zero, so rounding errors do not build up.
+*/
+class RmsMeter : public Meter
+{
+public:
+	/** RmsMeter constructor. \n
+		signalIn - input audio signal. \n
+		winTime - window length in seconds. \n
+		decim - decimation factor of the output. \n
+		vsiz - number of frames in the input vector. \n
+		sr - sampling rate of the input.
+	*/
+	RmsMeter(UGen& signalIn, double winTime = def_meter_win, size_t decim = 1,
+		size_t vsiz = def_vsize, double sr = def_sr) :
+		Meter(signalIn, winTime, decim, vsiz, sr), m_pos(0), m_sum(0.), m_fresh(0.)
+	{
+		m_squares.assign(m_win, 0.);
+	};
+
+	/** Clear the window.
+	*/
+	void reset();
+
+protected:
+	void dsp() override;
+
+private:
+	std::vector<double> m_squares;
+	size_t m_pos;
+	double m_sum, m_fresh;
+};
+
+/** Peak hold over a sliding window: the largest absolute value of the
+	last window of samples. The candidates for the maximum are kept in
+	a monotonic queue, so each sample is pushed and popped at most once.
+*/
+class PeakMeter : public Meter
+{
+public:
+	/** PeakMeter constructor. \n
+		signalIn - input audio signal. \n
+		winTime - window length in seconds. \n
+		decim - decimation factor of the output. \n
+		vsiz - number of frames in the input vector. \n
+		sr - sampling rate of the input.
+	*/
+	PeakMeter(UGen& signalIn, double winTime = def_meter_win, size_t decim = 1,
+		size_t vsiz = def_vsize, double sr = def_sr) :
+		Meter(signalIn, winTime, decim, vsiz, sr), m_count(0), m_head(0), m_size(0)
+	{
+		m_vals.assign(m_win, 0.);
+		m_times.assign(m_win, 0);
+	};
+
+	/** Clear the window.
+	*/
+	void reset();
+
+protected:
+	void dsp() override;
+
+private:
+	std::vector<double> m_vals;
+	std::vector<size_t> m_times;
+	size_t m_count, m_head, m_size;
+};
+
+}
+
+#endif
@@ -0,0 +1,143 @@
+/////////////////////////////////////////////////////////////////////
+// DelayWrite and DelayTap classes: multi-tap delay line
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _MULTITAP_H_
+#define _MULTITAP_H_
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+
+/** Write side of a multi-tap delay line. It stores the input signal
+	once in a shared buffer that any number of DelayTap readers access,
+	and passes the input through unchanged. \n
+	It has to be processed before its taps on every vector.
+*/
+class DelayWrite : public UGen
+{
+	friend class DelayTap;
+
+public:
+	/** DelayWrite constructor. \n
+		signalIn - input audio signal. \n
+		maxDel - max value of delay of the taps. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	DelayWrite(UGen& signalIn, double maxDel, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_maxDel(maxDel >= 0. ? std::ceil(maxDel * sr) : 1.),
+		m_writePos(0), m_blockStart(0), UGen(vsiz, sr)
+	{
+		// Room for the max delay plus the vector just written
+		size_t siz = 1;
+		while (siz < (size_t)m_maxDel + vsiz) siz <<= 1;
+		m_delLine.assign(siz, 0.);
+		m_mask = siz - 1;
+	};
+
+	/** Get the buffer position of the first sample of the last vector written.
+	*/
+	size_t getBlockStart() const { return m_blockStart; }
+
+	/** Get the current state of the delay line.
+	*/
+	const std::vector<double>& getDelayline() const { return m_delLine; }
+
+protected:
+	void dsp() override;
+
+private:
+	UGen& m_sigIn;
+	std::vector<double> m_delLine;
+	double m_maxDel;
+	size_t m_writePos, m_blockStart, m_mask;
+};
+
+/** Read side of a multi-tap delay line, with its own delay,
+	interpolation and feedback into the shared buffer. \n
+	The feedback is added in place to the vector that the DelayWrite
+	has just written. It is exact for a single tap with any delay, and for
+	several taps with feedback when their delays are at least one vector long. \n
+	A tap reads and feeds back one vector of the writer, so its vector
+	size is always the writer's.
+*/
+class DelayTap : public UGen
+{
+public:
+	/** DelayTap constructor. \n
+		writer - delay line to read from. \n
+		del - current value of delay. \n
+		feedback - amount of feedback (should not exceed 1). \n
+		interpolate - allow for linear interpolation. \n
+		vsiz - unused, the vector size is the writer's. \n
+		sr - sampling rate.
+	*/
+	DelayTap(DelayWrite& writer, double del, double feedback = 0., bool interpolate = false,
+		size_t /*vsiz*/ = def_vsize, double sr = def_sr) :
+		m_writer(writer), m_delVal(del), m_fb(feedback), m_interp(interpolate), UGen(writer.vsize(), sr) { };
+
+	/** DelayTap constructor. \n
+		writer - delay line to read from. \n
+		del - current value of delay. \n
+		feedback - amount of feedback (should not exceed 1). \n
+		interpolate - allow for linear interpolation. \n
+		vsiz - unused, the vector size is the writer's. \n
+		sr - sampling rate.
+	*/
+	DelayTap(DelayWrite& writer, UGen& del, double feedback = 0., bool interpolate = true,
+		size_t /*vsiz*/ = def_vsize, double sr = def_sr) :
+		m_writer(writer), m_delVal(del), m_fb(feedback), m_interp(interpolate), UGen(writer.vsize(), sr) { };
+
+	/** DelayTap constructor. \n
+		writer - delay line to read from. \n
+		del - current value of delay. \n
+		feedback - amount of feedback (should not exceed 1). \n
+		interpolate - allow for linear interpolation. \n
+		vsiz - unused, the vector size is the writer's. \n
+		sr - sampling rate.
+	*/
+	DelayTap(DelayWrite& writer, double del, UGen& feedback, bool interpolate = false,
+		size_t /*vsiz*/ = def_vsize, double sr = def_sr) :
+		m_writer(writer), m_delVal(del), m_fb(feedback), m_interp(interpolate), UGen(writer.vsize(), sr) { };
+
+	/** DelayTap constructor. \n
+		writer - delay line to read from. \n
+		del - current value of delay. \n
+		feedback - amount of feedback (should not exceed 1). \n
+		interpolate - allow for linear interpolation. \n
+		vsiz - unused, the vector size is the writer's. \n
+		sr - sampling rate.
+	*/
+	DelayTap(DelayWrite& writer, UGen& del, UGen& feedback, bool interpolate = true,
+		size_t /*vsiz*/ = def_vsize, double sr = def_sr) :
+		m_writer(writer), m_delVal(del), m_fb(feedback), m_interp(interpolate), UGen(writer.vsize(), sr) { };
+
+	void setDel(double val) { m_delVal.set(val); }
+	void setDel(UGen& modulator) { m_delVal.set(modulator); }
+
+	void setFeedback(double val) { m_fb.set(val); }
+	void setFeedback(UGen& modulator) { m_fb.set(modulator); }
+
+	void setInterp(bool val) { m_interp = val; }
+
+protected:
+	UGenParam m_delVal;
+	UGenParam m_fb;
+
+	void dsp() override;
+
+private:
+	DelayWrite& m_writer;
+	bool m_interp;
+};
+
+}
+#endif
@@ -11,6 +11,7 @@
 /////////////////////////////////////////////////////////////////////
 #ifndef _OSC_H_
 #define _OSC_H_
+#include <memory>
 #include "FuncTab.h"
 #include "UGen.h"
 #include "Phasor.h"
@@ -35,7 +36,7 @@ public:
 	*/
 	Osc(double amp, double fr, const FuncTab& tab,
 		double ph = 0., double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
-		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(m_ph, tab, true, true, vsiz, sr), m_dcoff(dco),
+		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(new TableRead(m_ph, tab, true, true, vsiz, sr)), m_dcoff(dco),
 		UGen(vsiz, sr) { };
 
 	/** Osc constructor. \n
@@ -49,7 +50,7 @@ public:
 	*/
 	Osc(double amp, UGen& fr, const FuncTab& tab,
 		double ph = 0., double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
-		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(m_ph, tab, true, true, vsiz, sr), m_dcoff(dco),
+		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(new TableRead(m_ph, tab, true, true, vsiz, sr)), m_dcoff(dco),
 		UGen(vsiz, sr) { };
 
 	/** Osc constructor. \n
@@ -63,7 +64,7 @@ public:
 	*/
 	Osc(UGen& amp, double fr, const FuncTab& tab,
 		double ph = 0., double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
-		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(m_ph, tab, true, true, vsiz, sr), m_dcoff(dco),
+		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(new TableRead(m_ph, tab, true, true, vsiz, sr)), m_dcoff(dco),
 		UGen(vsiz, sr) { };
 
 	/** Osc constructor. \n
@@ -77,7 +78,7 @@ public:
 	*/
 	Osc(UGen& amp, UGen& fr, const FuncTab& tab,
 		double ph = 0., double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
-		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(m_ph, tab, true, true, vsiz, sr), m_dcoff(dco),
+		m_amp(amp), m_ph(fr, ph, vsiz, sr), m_tr(new TableRead(m_ph, tab, true, true, vsiz, sr)), m_dcoff(dco),
 		UGen(vsiz, sr) { };
 
 	void setFreq(double val) { m_ph.setFreq(val); }
@@ -86,17 +87,24 @@ public:
 	void setAmp(double val) { m_amp.set(val); }
 	void setAmp(UGen& modulator) { m_amp.set(modulator); }
 
+	/** Reset the phase at a sample of the next vectors,
+		false if too many events are waiting. \n
+		offset - sample offset from the start of the next vector. \n
+		ph - normalized phase from that sample on.
+	*/
+	bool resetAt(size_t offset, double ph = 0.) { return m_ph.resetAt(offset, ph); }
+
 protected:
 	/** Protected Osc constructor for setting different
 		Phasors and TableReads in derived classes constructors. \n
 		amp - amplitude. \n
 		ph - phasor. \n
-		tr - table read. \n
+		tr - table read, owned by the oscillator. \n
 		dco - DC offset to add. \n
 		vsiz - number of frames in vector. \n
 		sr - sampling rate.
 	*/
-	Osc(UGen& amp, Phasor ph, TableRead tr,
+	Osc(UGen& amp, Phasor ph, TableRead* tr,
 		double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
 		m_amp(amp), m_ph(ph), m_tr(tr), m_dcoff(dco),
 		UGen(vsiz, sr) { };
@@ -105,12 +113,12 @@ protected:
 		Phasors and TableReads in derived classes constructors. \n
 		amp - amplitude. \n
 		ph - phasor. \n
-		tr - table read. \n
+		tr - table read, owned by the oscillator. \n
 		dco - DC offset to add. \n
 		vsiz - number of frames in vector. \n
 		sr - sampling rate.
 	*/
-	Osc(double amp, Phasor ph, TableRead tr,
+	Osc(double amp, Phasor ph, TableRead* tr,
 		double dco = 0., size_t vsiz = def_vsize, double sr = def_sr) :
 		m_amp(amp), m_ph(ph), m_tr(tr), m_dcoff(dco),
 		UGen(vsiz, sr) { };
@@ -121,7 +129,7 @@ protected:
 
 private:
 	UGenParam m_amp;
-	TableRead m_tr;
+	std::unique_ptr<TableRead> m_tr;
 	double m_dcoff;
 };
 
@@ -141,7 +149,7 @@ public:
 	*/
 	OscI(double amp, double fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscI constructor. \n
 		amp - amplitude. \n
@@ -154,7 +162,7 @@ public:
 	*/
 	OscI(double amp, UGen& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscI constructor. \n
 		amp - amplitude. \n
@@ -167,7 +175,7 @@ public:
 	*/
 	OscI(UGen& amp, double fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscI constructor. \n
 		amp - amplitude. \n
@@ -180,7 +188,7 @@ public:
 	*/
 	OscI(UGen& amp, UGen& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 };
 
 /** Cubic interpolation oscillator.
@@ -199,7 +207,7 @@ public:
 	*/
 	OscC(double amp, double fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadC(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscC constructor. \n
 		amp - amplitude. \n
@@ -212,7 +220,7 @@ public:
 	*/
 	OscC(double amp, UGen& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadC(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscC constructor. \n
 		amp - amplitude. \n
@@ -225,7 +233,7 @@ public:
 	*/
 	OscC(UGen& amp, double fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadC(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 
 	/** OscC constructor. \n
 		amp - amplitude. \n
@@ -238,7 +246,7 @@ public:
 	*/
 	OscC(UGen& amp, UGen& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
 		size_t vsiz = def_vsize, double sr = def_sr) :
-		Osc(amp, Phasor(fr, ph, vsiz, sr), TableReadI(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
+		Osc(amp, Phasor(fr, ph, vsiz, sr), new TableReadC(m_ph, tab, true, true, vsiz, sr), dco, vsiz, sr) {};
 };
 
 }
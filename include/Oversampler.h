@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////
+// HalfBand and Oversampler classes: polyphase oversampling of
+// a subgraph
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _OVERSAMPLER_H_
+#define _OVERSAMPLER_H_
+#include <vector>
+#include "UGen.h"
+#include "ExternalUGen.h"
+
+namespace KiwiWaves
+{
+
+/** Kaiser-windowed half-band FIR filter, as a 2x polyphase interpolator
+	and decimator. Half of its taps are zero and the rest are symmetric,
+	so each output sample takes one multiply per pair of taps.
+*/
+class HalfBand
+{
+public:
+	/** HalfBand constructor. \n
+		taps - number of nonzero taps on each side of the center. \n
+		block - number of frames at the lower rate per call.
+	*/
+	HalfBand(size_t taps, size_t block);
+
+	/** Interpolate block samples into 2 * block samples.
+	*/
+	void up(const double* in, double* out);
+
+	/** Decimate 2 * block samples into block samples.
+	*/
+	void down(const double* in, double* out);
+
+	/** Get the delay of up() or down() in samples at the higher rate.
+	*/
+	size_t latency() const { return 2 * m_coefs.size() - 1; }
+
+	/** Clear the filter states.
+	*/
+	void reset();
+
+private:
+	std::vector<double> m_coefs, m_upBuf, m_downBuf;
+	size_t m_block;
+};
+
+/** Oversampling container for nonlinear subgraphs. The input is
+	upsampled 2x, 4x or 8x by a cascade of half-band stages into
+	input(), the children are processed in order at the higher rate and
+	vector size, and the output of the last child is decimated back. \n
+	The children have to be built with innerVsize() and innerSr() and
+	read input() or each other. The first stage has the steepest filter,
+	the later ones only remove the images of the band already limited.
+*/
+class Oversampler : public UGen
+{
+public:
+	/** Oversampler constructor. \n
+		signalIn - input audio signal. \n
+		factor - oversampling factor, 2, 4 or 8. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	Oversampler(UGen& signalIn, size_t factor = 2, size_t vsiz = def_vsize, double sr = def_sr);
+
+	/** Get the upsampled input, the source of the subgraph.
+	*/
+	ExternalUGen& input() { return m_inner; }
+
+	/** Add a child to the subgraph. The children are processed
+		in the order they are added and the last one is the output.
+	*/
+	void add(UGen& child) { m_children.push_back(&child); }
+
+	/** Get the oversampling factor.
+	*/
+	size_t factor() const { return m_inner.vsize() / m_s.size(); }
+
+	/** Get the vector size of the subgraph.
+	*/
+	size_t innerVsize() const { return m_inner.vsize(); }
+
+	/** Get the sampling rate of the subgraph.
+	*/
+	double innerSr() const { return m_inner.sr(); }
+
+	/** Get the latency of the resampling filters in samples.
+	*/
+	double latency() const;
+
+	/** Clear the filter states.
+	*/
+	void reset();
+
+protected:
+	void dsp() override;
+
+private:
+	UGen& m_sigIn;
+	ExternalUGen m_inner;
+	std::vector<HalfBand> m_stages;
+	std::vector<UGen*> m_children;
+	std::vector<double> m_bufA, m_bufB;
+};
+
+}
+
+#endif
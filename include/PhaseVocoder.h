@@ -0,0 +1,151 @@
+/////////////////////////////////////////////////////////////////////
+// PhaseVocoder class: time-stretch and pitch-shift of a table
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _PHASEVOCODER_H_
+#define _PHASEVOCODER_H_
+#include <vector>
+#include "UGen.h"
+#include "FuncTab.h"
+#include "Fft.h"
+
+namespace KiwiWaves
+{
+
+/** Phase vocoder that plays a function table back with independent
+	time-stretch and pitch-shift ratios. Frames are analysed every
+	hopSize() / stretch source samples and resynthesised every
+	hopSize() output samples with identity phase locking: the bins around
+	each spectral peak keep their phase relation to the peak, and the
+	peak regions are moved to the pitch-shifted frequency. \n
+	All the frame buffers are allocated by the constructor. The table is
+	read by reference, so it has to outlive the PhaseVocoder.
+*/
+class PhaseVocoder : public UGen
+{
+public:
+	/** PhaseVocoder constructor. \n
+		source - table to play back. \n
+		stretch - time-stretch ratio (output over source duration). \n
+		pitch - pitch-shift ratio. \n
+		fftSiz - frame size, rounded up to a power of two. \n
+		hop - synthesis hop size (at most a quarter of the frame size). \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	PhaseVocoder(const FuncTab& source, double stretch = 1., double pitch = 1., size_t fftSiz = def_fft_size,
+		size_t hop = def_hop_size, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_src(source), m_stretch(stretch), m_pitch(pitch), m_fft(fftSiz), UGen(vsiz, sr)
+	{
+		init(hop);
+	};
+
+	/** PhaseVocoder constructor. \n
+		source - table to play back. \n
+		stretch - time-stretch ratio (output over source duration). \n
+		pitch - pitch-shift ratio. \n
+		fftSiz - frame size, rounded up to a power of two. \n
+		hop - synthesis hop size (at most a quarter of the frame size). \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	PhaseVocoder(const FuncTab& source, UGen& stretch, double pitch = 1., size_t fftSiz = def_fft_size,
+		size_t hop = def_hop_size, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_src(source), m_stretch(stretch), m_pitch(pitch), m_fft(fftSiz), UGen(vsiz, sr)
+	{
+		init(hop);
+	};
+
+	/** PhaseVocoder constructor. \n
+		source - table to play back. \n
+		stretch - time-stretch ratio (output over source duration). \n
+		pitch - pitch-shift ratio. \n
+		fftSiz - frame size, rounded up to a power of two. \n
+		hop - synthesis hop size (at most a quarter of the frame size). \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	PhaseVocoder(const FuncTab& source, double stretch, UGen& pitch, size_t fftSiz = def_fft_size,
+		size_t hop = def_hop_size, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_src(source), m_stretch(stretch), m_pitch(pitch), m_fft(fftSiz), UGen(vsiz, sr)
+	{
+		init(hop);
+	};
+
+	/** PhaseVocoder constructor. \n
+		source - table to play back. \n
+		stretch - time-stretch ratio (output over source duration). \n
+		pitch - pitch-shift ratio. \n
+		fftSiz - frame size, rounded up to a power of two. \n
+		hop - synthesis hop size (at most a quarter of the frame size). \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	PhaseVocoder(const FuncTab& source, UGen& stretch, UGen& pitch, size_t fftSiz = def_fft_size,
+		size_t hop = def_hop_size, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_src(source), m_stretch(stretch), m_pitch(pitch), m_fft(fftSiz), UGen(vsiz, sr)
+	{
+		init(hop);
+	};
+
+	void setStretch(double val) { m_stretch.set(val); }
+	void setStretch(UGen& modulator) { m_stretch.set(modulator); }
+
+	void setPitch(double val) { m_pitch.set(val); }
+	void setPitch(UGen& modulator) { m_pitch.set(modulator); }
+
+	/** Move the read position in the table. The phases are reset. \n
+		pos - position in samples.
+	*/
+	void setPosition(double pos) { m_pos = pos > 0. ? pos : 0.; m_first = true; }
+
+	/** Get the read position in the table, in samples.
+	*/
+	double getPosition() const { return m_pos; }
+
+	/** True once the read position has gone past the end of the table.
+	*/
+	bool done() const { return m_pos >= (double)m_src.size(); }
+
+	/** Get the synthesis hop size.
+	*/
+	size_t hopSize() const { return m_hop; }
+
+protected:
+	const FuncTab& m_src;
+	UGenParam m_stretch;
+	UGenParam m_pitch;
+	Fft m_fft;
+	size_t m_hop;
+
+	void dsp() override;
+
+private:
+	std::vector<double> m_win, m_time, m_re, m_im, m_acc, m_outBuf;
+	std::vector<double> m_mag, m_phase, m_prevPhase, m_freq;
+	std::vector<double> m_outMag, m_outPh, m_synPh;
+	std::vector<size_t> m_peaks;
+	double m_pos, m_norm;
+	size_t m_prevStart, m_fill;
+	bool m_first;
+
+	/** Allocate the frame buffers.
+	*/
+	void init(size_t hop);
+
+	/** Analyse, modify and resynthesise one frame. \n
+		indx - position of the frame in the vector.
+	*/
+	void frame(size_t indx);
+};
+
+}
+
+#endif
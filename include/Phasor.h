@@ -12,6 +12,7 @@
 #ifndef _PHASOR_H_
 #define _PHASOR_H_
 #include "UGen.h"
+#include "Events.h"
 
 namespace KiwiWaves
 {
@@ -42,12 +43,20 @@ public:
 	void setFreq(double val) { m_fr.set(val); }
 	void setFreq(UGen& modulator) { m_fr.set(modulator); }
 
+	/** Reset the phase at a sample of the next vectors,
+		false if too many events are waiting. \n
+		offset - sample offset from the start of the next vector. \n
+		ph - normalized phase from that sample on.
+	*/
+	bool resetAt(size_t offset, double ph = 0.) { return m_events.push(offset, resetEvent, ph); }
+
 protected:
 	void dsp() override;
 
 private:
 	UGenParam m_fr;
 	double m_ph;
+	EventQueue m_events;
 };
 
 }
@@ -0,0 +1,129 @@
+/////////////////////////////////////////////////////////////////////
+// Profile: per-UGen processing counters and CPU load reports
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _PROFILE_H_
+#define _PROFILE_H_
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <chrono>
+#include <typeinfo>
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#define KIWIWAVES_PROFILE_TSC
+#endif
+
+namespace KiwiWaves
+{
+
+class UGen;
+
+/** Instrumentation of UGen::process(), compiled in when KIWIWAVES_PROFILE
+	is defined (the KIWIWAVES_PROFILE CMake option). Every UGen then counts
+	its calls, the samples it produced and the ticks spent in its own dsp(),
+	excluding the UGens it processed from it. The cost is two timestamp
+	reads per call. \n
+	The counters are written by the thread that processes the UGen, so
+	read them between process() calls. The timestamps and type names are
+	also used by the tracer, and are available in every build.
+*/
+namespace Profile
+{
+	/** Read the timestamp counter: the TSC on x86, nanoseconds of the
+		steady clock elsewhere.
+	*/
+	inline uint64_t ticks()
+	{
+#ifdef KIWIWAVES_PROFILE_TSC
+		return __rdtsc();
+#else
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+	}
+
+	/** Get the tick rate, measured against the steady clock on the first call.
+	*/
+	double ticksPerSecond();
+
+	/** Get the name of a UGen type, without the namespace.
+	*/
+	std::string typeName(const std::type_info& type);
+
+	/** Processing counters of a UGen.
+	*/
+	struct Counters
+	{
+		uint64_t calls = 0;
+		uint64_t samples = 0;
+		uint64_t ticks = 0;
+		uint64_t maxTicks = 0;
+
+		/** Count one call that produced n samples in t ticks.
+		*/
+		inline void add(uint64_t t, size_t n)
+		{
+			calls++;
+			samples += n;
+			ticks += t;
+			maxTicks = t > maxTicks ? t : maxTicks;
+		}
+
+		/** Set all counters to zero.
+		*/
+		void reset() { *this = Counters(); }
+	};
+
+	/** Line of a report, for a UGen or for all the UGens of a type.
+	*/
+	struct Entry
+	{
+		std::string name;
+		size_t instances;
+		Counters counters;
+		double share;
+		double load;
+	};
+
+	/** CPU load report of a graph. The share is the fraction of the ticks
+		of the graph spent in an entry, and the load is the fraction of the
+		real time of the audio processed, at the rate of the ticks.
+	*/
+	struct Report
+	{
+		std::vector<Entry> ugens;
+		std::vector<Entry> types;
+		uint64_t ticks;
+		double seconds;
+		double load;
+	};
+
+	/** Build the report of the UGens of a graph, sorted by ticks. \n
+		graph - the UGens to report, each one once.
+	*/
+	Report report(const std::vector<const UGen*>& graph);
+
+	/** Print a report as two tables, per UGen and per type.
+	*/
+	void print(const Report& rep, std::ostream& os);
+
+	/** Set the counters of the UGens of a graph to zero.
+	*/
+	void reset(const std::vector<UGen*>& graph);
+}
+
+}
+#endif
@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////
+// Resampler class: streaming sample-rate converter
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _RESAMPLER_H_
+#define _RESAMPLER_H_
+#include <vector>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+
+/** Streaming sample-rate converter with arbitrary and modulatable ratio.
+	The input signal runs at its own sampling rate and vector size, and
+	the resampler processes it whenever it needs more samples, so the
+	input must not be processed by anything else. \n
+	Each output sample is a dot product of the input with a Kaiser-windowed
+	sinc, read from a polyphase table and linearly interpolated between
+	phases. The cutoff follows the lower of the two rates, so varispeed
+	above 1 may alias.
+*/
+class Resampler : public UGen
+{
+public:
+	/** Resampler constructor. \n
+		signalIn - input audio signal, at its own sampling rate. \n
+		speed - playback speed, 1 for a plain rate conversion. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate of the output.
+	*/
+	Resampler(UGen& signalIn, double speed = 1., size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_speed(speed), UGen(vsiz, sr)
+	{
+		init();
+	};
+
+	/** Resampler constructor. \n
+		signalIn - input audio signal, at its own sampling rate. \n
+		speed - playback speed, 1 for a plain rate conversion. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate of the output.
+	*/
+	Resampler(UGen& signalIn, UGen& speed, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_sigIn(signalIn), m_speed(speed), UGen(vsiz, sr)
+	{
+		init();
+	};
+
+	void setSpeed(double val) { m_speed.set(val); }
+	void setSpeed(UGen& modulator) { m_speed.set(modulator); }
+
+	/** Get the ratio of input to output sampling rate.
+	*/
+	double ratio() const { return m_ratio; }
+
+	/** Clear the input history.
+	*/
+	void reset();
+
+protected:
+	UGen& m_sigIn;
+	UGenParam m_speed;
+
+	void dsp() override;
+
+private:
+	std::vector<double> m_table, m_diff, m_fifo;
+	double m_ratio, m_pos;
+	size_t m_fill;
+
+	/** Build the filter table and allocate the input buffer.
+	*/
+	void init();
+
+	/** Process the next input vector into the buffer.
+	*/
+	void pull();
+};
+
+}
+
+#endif
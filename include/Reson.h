@@ -74,8 +74,21 @@ public:
 		update();
 	};
 
+	/** Compute the resonator coefficients. \n
+		freq - center frequency. \n
+		band - bandwidth. \n
+		sr - sampling rate. \n
+		a - output feedforward coefficients (a0, a1, a2). \n
+		b - output feedback coefficients (b1, b2). \n
+		scal - output input scaling. \n
+		prec - with fastMath, the scaling uses a square root instead of sin(acos()).
+	*/
+	static void coefs(double freq, double band, double sr, double* a, double* b, double& scal,
+		MathPrecision prec = preciseMath);
+
 protected:
     void update() override;
+    FilterDesign design() const override { return resonDesign; }
 };
 
 /** Original band-pass resonator design.
@@ -126,6 +139,7 @@ public:
 
 protected:
     void dsp() override;
+    void filterSpan(const double* in, double* out, size_t frames, double* del) const override;
 };
 
 /** Band-pass resonator with better amplitude response at low frequencies (alternative design).
@@ -16,7 +16,9 @@
 namespace KiwiWaves
 {
 
-/** Estimate the root-means-square of a signal.
+/** Estimate the root-means-square of a signal. The rectified input is
+	smoothed by a first-order low-pass filter, whose coefficients are
+	only recomputed where the cutoff changes.
 */
 class Rms : public ToneLP
 {
@@ -39,13 +41,24 @@ public:
 	Rms(UGen& signalIn, UGen& cutFreq, size_t vsiz = def_vsize, double sr = def_sr) :
 		ToneLP(signalIn, cutFreq, vsiz, sr) { };
 
+	/** Run two estimators with the same coefficients side by side,
+		so that both recursions share the vector registers. \n
+		in1, in2 - input signals. \n
+		out1, out2 - output estimates. \n
+		n - number of samples. \n
+		a, b - filter coefficients, see ToneLP::coefs(). \n
+		del1, del2 - filter states, updated.
+	*/
+	static void processPair(const double* in1, const double* in2, double* out1, double* out2,
+		size_t n, double a, double b, double& del1, double& del2);
+
 protected:
 	void dsp() override;
 
 private:
 	/** Low-pass filter rectification for calculating the RMS (absolute value).
 	*/
-	double rect(double x);
+	static double rect(double x) { return std::fabs(x); }
 
 };
 
@@ -0,0 +1,162 @@
+/////////////////////////////////////////////////////////////////////
+// Scheduler and ControlSig classes: sample-accurate event scheduling
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+#include <vector>
+#include "UGen.h"
+#include "Events.h"
+#include "SegmentEnv.h"
+#include "Osc.h"
+
+namespace KiwiWaves
+{
+
+/** Control signal that holds a value and steps to new values at
+	sample offsets, to drive any modulatable parameter from events.
+*/
+class ControlSig : public UGen
+{
+public:
+	/** ControlSig constructor. \n
+		val - initial value. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	ControlSig(double val = 0., size_t vsiz = def_vsize, double sr = def_sr) :
+		m_val(val), UGen(vsiz, sr) { };
+
+	/** Set the value from the next vector on.
+	*/
+	void set(double val) { m_val = val; }
+
+	/** Set the value at a sample of the next vectors,
+		false if too many events are waiting. \n
+		offset - sample offset from the start of the next vector. \n
+		val - value from that sample on.
+	*/
+	bool setAt(size_t offset, double val) { return m_events.push(offset, setEvent, val); }
+
+protected:
+	void dsp() override;
+
+private:
+	double m_val;
+	EventQueue m_events;
+};
+
+/** Event callback of a Scheduler, false if the target could not take
+	the event (its queue is full). \n
+	target - object the event was scheduled for. \n
+	offset - sample offset of the event in the next vector. \n
+	value - event parameter.
+*/
+typedef bool (*EventFn)(void* target, size_t offset, double value);
+
+/** Scheduler of events at absolute sample times. The events wait in a
+	binary heap allocated by the constructor, so scheduling and
+	dispatching do not allocate. \n
+	Every vector, the events that fall in it are passed to their targets
+	with their sample offset, and the targets split their own processing
+	at those offsets. The scheduler has to be processed before its
+	targets. Its output counts the events dispatched at each sample. \n
+	A target holds up to def_event_capacity events per vector. The events
+	it cannot take stay in the heap and are dispatched at the start of
+	the next vector, in order, and they are counted by deferred().
+*/
+class Scheduler : public UGen
+{
+public:
+	/** Scheduler constructor. \n
+		capacity - max number of events waiting. \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	Scheduler(size_t capacity = def_sched_capacity, size_t vsiz = def_vsize, double sr = def_sr) :
+		m_time(0), m_seq(0), m_deferred(0), UGen(vsiz, sr)
+	{
+		m_heap.reserve(capacity > 0 ? capacity : 1);
+		m_held.reserve(capacity > 0 ? capacity : 1);
+	};
+
+	/** Schedule a callback, false if the heap is full. Events at the
+		same time are dispatched in the order they were scheduled. \n
+		time - absolute time in samples, late events happen at the next vector. \n
+		fn - callback. \n
+		target - object passed to the callback. \n
+		value - event parameter.
+	*/
+	bool schedule(uint64_t time, EventFn fn, void* target, double value = 0.);
+
+	/** Schedule a retrig of an envelope, false if the heap is full.
+	*/
+	bool retrigAt(uint64_t time, SegmentEnv& env);
+
+	/** Schedule the release of an envelope, false if the heap is full.
+	*/
+	bool releaseAt(uint64_t time, SegmentEnv& env);
+
+	/** Schedule a phase reset, false if the heap is full.
+	*/
+	bool resetAt(uint64_t time, Phasor& ph, double phase = 0.);
+
+	/** Schedule a phase reset of an oscillator, false if the heap is full.
+	*/
+	bool resetAt(uint64_t time, Osc& osc, double phase = 0.);
+
+	/** Schedule a new value of a control signal, false if the heap is full.
+	*/
+	bool setAt(uint64_t time, ControlSig& sig, double value);
+
+	/** Get the time of the next vector in samples.
+	*/
+	uint64_t now() const { return m_time; }
+
+	/** Get the number of events waiting.
+	*/
+	size_t pending() const { return m_heap.size(); }
+
+	/** Get the number of times an event was put off to the next vector
+		because its target was full.
+	*/
+	uint64_t deferred() const { return m_deferred; }
+
+	/** Remove all the events waiting.
+	*/
+	void clear() { m_heap.clear(); }
+
+protected:
+	void dsp() override;
+
+private:
+	struct Entry
+	{
+		uint64_t time, seq;
+		EventFn fn;
+		void* target;
+		double value;
+
+		/** Heap order, the earliest entry on top.
+		*/
+		bool operator<(const Entry& other) const
+		{
+			return time != other.time ? time > other.time : seq > other.seq;
+		}
+	};
+
+	std::vector<Entry> m_heap;
+	std::vector<Entry> m_held;
+	uint64_t m_time, m_seq, m_deferred;
+};
+
+}
+
+#endif
@@ -12,12 +12,17 @@
 #ifndef _SEGMENTENV_H_
 #define _SEGMENTENV_H_
 #include "UGen.h"
+#include "Events.h"
 #include <vector>
 
 namespace KiwiWaves
 {
 
-/** Multi-segment envelope generator.
+/** Multi-segment envelope generator. Each vector is split only at the
+	segment boundaries: the segments are generated in closed form and
+	the holds are filled as constants. \n
+	Retrigs and releases can be scheduled at sample offsets of the next
+	vectors, or driven by the edges of a gate signal.
 */
 class SegmentEnv : public UGen
 {
@@ -33,12 +38,12 @@ public:
 	*/
 	SegmentEnv(std::vector<double> levels, std::vector<double> times, std::vector<Curve> curves,
 		double offset = 0., bool lastSegIsRelease = false, size_t vsiz = def_vsize, double sr = def_sr) :
-		m_levels(levels), m_times(times), m_curves(curves),
-		m_offset(offset), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true),
+		m_levels(levels), m_times(times), m_curves(curves), m_ind(0),
+		m_offset(offset), m_gate(nullptr), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true), m_gateOn(false),
 		UGen(vsiz, sr)
 	{
 		if (!checkVectorSizes()) fillDataToZero();
-		solveZeros();
+		else solveZeros();
 		retrig();
 	};
 
@@ -54,7 +59,7 @@ public:
 	SegmentEnv(std::vector<double> levels, std::vector<double> times, Curve curve = linear,
 		double offset = 0., bool lastSegIsRelease = false, size_t vsiz = def_vsize, double sr = def_sr) :
 		m_levels(levels), m_times(times), m_curves(std::vector<Curve>(times.size(), curve)),
-		m_offset(offset), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true), 
+		m_offset(offset), m_gate(nullptr), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true), m_gateOn(false), 
 		UGen(vsiz, sr)
 	{
 		if (!checkVectorSizes()) fillDataToZero();
@@ -74,7 +79,7 @@ public:
 	SegmentEnv(double start, double end, double time, Curve curve = linear,
 		double offset = 0., bool lastSegIsRelease = false, size_t vsiz = def_vsize, double sr = def_sr) :
 		m_levels{start, end}, m_times{time}, m_curves{curve},
-		m_offset(offset), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true), 
+		m_offset(offset), m_gate(nullptr), m_releaseSeg(lastSegIsRelease), m_validVectorSizes(true), m_gateOn(false), 
 		UGen(vsiz, sr)
 	{
 		if (!checkVectorSizes()) fillDataToZero();
@@ -89,20 +94,60 @@ public:
 	*/
 	void release();
 
+	/** Retrig the envelope at a sample of the next vectors,
+		false if too many events are waiting. \n
+		offset - sample offset from the start of the next vector.
+	*/
+	bool scheduleRetrig(size_t offset) { return m_events.push(offset, retrigEvent); }
+
+	/** Start the release at a sample of the next vectors,
+		false if too many events are waiting. \n
+		offset - sample offset from the start of the next vector.
+	*/
+	bool scheduleRelease(size_t offset) { return m_events.push(offset, releaseEvent); }
+
+	/** Drive the envelope with a gate signal: a rising edge above zero
+		retrigs it and a falling edge starts the release. \n
+		gate - gate signal, processed before the envelope.
+	*/
+	void setGate(UGen& gate) { m_gate = &gate; }
+
+	/** Stop following the gate signal.
+	*/
+	void clearGate() { m_gate = nullptr; m_gateOn = false; }
+
 protected:
 	void dsp() override;
 
 private:
 	std::vector<double> m_levels, m_times;
 	std::vector<Curve> m_curves;
-	unsigned int m_count, m_ind;
-	double m_offset, m_val, m_incr;
-	bool m_releaseSeg, m_validVectorSizes;
+	unsigned int m_count, m_ind, m_steps;
+	double m_offset, m_val, m_start, m_incr;
+	EventQueue m_events;
+	UGen* m_gate;
+	bool m_releaseSeg, m_validVectorSizes, m_gateOn;
+
+	/** Generate the samples from position from up to position to.
+	*/
+	void generate(size_t from, size_t to);
+
+	/** Apply an event.
+	*/
+	void trigger(EventType type);
 
 	/** Start new segment.
 	*/
 	void startSegment(unsigned int newSegment);
 
+	/** Write the next len samples of a linear segment.
+	*/
+	void linSpan(double* out, size_t len);
+
+	/** Write the next len samples of an exponential segment.
+	*/
+	void expSpan(double* out, size_t len);
+
 	/** True if the vector m_levels, m_times and m_curves are correct.
 	*/
 	bool checkVectorSizes();
@@ -0,0 +1,541 @@
+/////////////////////////////////////////////////////////////////////
+// Static: header-only UGens composed at compile time
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _STATIC_H_
+#define _STATIC_H_
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include "UGen.h"
+#include "FuncTab.h"
+#include "Butterworth.h"
+#include "Tone.h"
+#include "Denormals.h"
+
+namespace KiwiWaves
+{
+
+/** Static versions of the core UGens. A static node computes one sample
+	per tick() and owns its inputs by value, so a chain of nodes is a single
+	type that the compiler inlines into one loop, without the virtual calls
+	and the parameter branches of the dynamic UGens. The nodes follow the
+	same arithmetic as the dynamic UGens, so a static chain produces the
+	same samples as the equivalent dynamic graph. \n
+	Chains are built with the factory functions, which take numbers for
+	fixed parameters, dynamic UGens for modulation and other nodes, and
+	are processed as a dynamic UGen by a Pipeline:
+	\code
+	auto voice = Static::lowP(Static::oscI(0.5, 220., tab) * Static::in(env), 2000.);
+	Static::Pipeline<decltype(voice)> out(voice);
+	\endcode
+*/
+namespace Static
+{
+	/** Base of the static nodes. Derived must provide double tick(), and
+		can override begin(n), called before the n ticks of a vector, and
+		end(), called after them. Composed nodes forward both calls to
+		their inputs.
+	*/
+	template <class Derived>
+	class Node
+	{
+	public:
+		Derived& self() { return static_cast<Derived&>(*this); }
+		const Derived& self() const { return static_cast<const Derived&>(*this); }
+
+		void begin(size_t) { }
+		void end() { }
+
+		/** Compute n samples into out.
+		*/
+		void render(double* out, size_t n)
+		{
+			Derived& d = self();
+			d.begin(n);
+			for (size_t i = 0; i < n; i++)
+				out[i] = d.tick();
+			d.end();
+		}
+	};
+
+	/** Fixed value.
+	*/
+	class Const : public Node<Const>
+	{
+	public:
+		/** Const constructor. \n
+			val - value.
+		*/
+		Const(double val) : m_val(val) { };
+
+		void set(double val) { m_val = val; }
+		double tick() const { return m_val; }
+
+	private:
+		double m_val;
+	};
+
+	/** Output of a dynamic UGen, read sample by sample. The UGen
+		must be processed before the chain that reads it.
+	*/
+	class In : public Node<In>
+	{
+	public:
+		/** In constructor. \n
+			ugen - UGen to read.
+		*/
+		In(UGen& ugen) : m_ugen(&ugen), m_data(nullptr), m_pos(0) { };
+
+		void begin(size_t) { m_data = m_ugen->data(); m_pos = 0; }
+		double tick() { return m_data[m_pos++]; }
+
+	private:
+		UGen* m_ugen;
+		const double* m_data;
+		size_t m_pos;
+	};
+
+	/** Node type of a factory argument: Const for numbers,
+		In for dynamic UGens, and the node itself otherwise.
+	*/
+	template <class T>
+	struct Param
+	{
+		typedef typename std::decay<T>::type U;
+		typedef typename std::conditional<std::is_arithmetic<U>::value, Const,
+			typename std::conditional<std::is_base_of<UGen, U>::value, In, U>::type>::type type;
+	};
+
+	template <class T>
+	using ParamOf = typename Param<T>::type;
+
+	/** Product of two nodes.
+	*/
+	template <class A, class B>
+	class Mul : public Node<Mul<A, B>>
+	{
+	public:
+		Mul(const A& a, const B& b) : m_a(a), m_b(b) { };
+
+		void begin(size_t n) { m_a.begin(n); m_b.begin(n); }
+		void end() { m_a.end(); m_b.end(); }
+		double tick() { return m_a.tick() * m_b.tick(); }
+
+	private:
+		A m_a;
+		B m_b;
+	};
+
+	/** Sum of two nodes.
+	*/
+	template <class A, class B>
+	class Add : public Node<Add<A, B>>
+	{
+	public:
+		Add(const A& a, const B& b) : m_a(a), m_b(b) { };
+
+		void begin(size_t n) { m_a.begin(n); m_b.begin(n); }
+		void end() { m_a.end(); m_b.end(); }
+		double tick() { return m_a.tick() + m_b.tick(); }
+
+	private:
+		A m_a;
+		B m_b;
+	};
+
+	template <class A, class B>
+	Mul<A, B> operator*(const Node<A>& a, const Node<B>& b) { return Mul<A, B>(a.self(), b.self()); }
+	template <class A>
+	Mul<A, Const> operator*(const Node<A>& a, double b) { return Mul<A, Const>(a.self(), b); }
+	template <class B>
+	Mul<Const, B> operator*(double a, const Node<B>& b) { return Mul<Const, B>(a, b.self()); }
+
+	template <class A, class B>
+	Add<A, B> operator+(const Node<A>& a, const Node<B>& b) { return Add<A, B>(a.self(), b.self()); }
+	template <class A>
+	Add<A, Const> operator+(const Node<A>& a, double b) { return Add<A, Const>(a.self(), b); }
+	template <class B>
+	Add<Const, B> operator+(double a, const Node<B>& b) { return Add<Const, B>(a, b.self()); }
+
+	/** Normalized phase ramp, as Phasor.
+	*/
+	template <class Freq>
+	class Phasor : public Node<Phasor<Freq>>
+	{
+	public:
+		/** Phasor constructor. \n
+			fr - frequency. \n
+			ph - initial phase. \n
+			sr - sampling rate.
+		*/
+		Phasor(const Freq& fr, double ph = 0., double sr = def_sr) : m_fr(fr), m_ph(ph), m_sr(sr) { };
+
+		void begin(size_t n) { m_fr.begin(n); }
+		void end() { m_fr.end(); }
+
+		double tick()
+		{
+			double out = m_ph;
+			m_ph += m_fr.tick() / m_sr;
+			m_ph = m_ph - std::floor(m_ph); // mod1
+			return out;
+		}
+
+	private:
+		Freq m_fr;
+		double m_ph, m_sr;
+	};
+
+	/** Table lookup, as TableRead (order 0), TableReadI (order 1)
+		and TableReadC (order 3).
+	*/
+	template <class Index, int order>
+	class TableReader : public Node<TableReader<Index, order>>
+	{
+	public:
+		/** TableReader constructor. \n
+			index - index to read. \n
+			tab - table to read. \n
+			norm - index normalized to the table size. \n
+			wrap - wrap the index around the table, clamp it if false.
+		*/
+		TableReader(const Index& index, const FuncTab& tab, bool norm = true, bool wrap = true) :
+			m_ind(index), m_table(tab), m_norm(norm), m_wrap(wrap) { };
+
+		void begin(size_t n) { m_ind.begin(n); }
+		void end() { m_ind.end(); }
+
+		double tick()
+		{
+			double tsiz = (double)m_table.size();
+			double raw = m_ind.tick() * (m_norm ? tsiz : 1);
+			if (m_wrap)
+			{
+				raw = std::fmod(raw, tsiz);
+				if (raw < 0.) raw = raw + tsiz < tsiz ? raw + tsiz : 0.;
+			}
+			else raw = std::max(0., std::min(raw, tsiz - 1.));
+			return read(raw);
+		}
+
+	private:
+		Index m_ind;
+		FuncTab m_table;
+		bool m_norm, m_wrap;
+
+		double read(double raw) const
+		{
+			const double* tab = m_table.data();
+			size_t s = m_table.size();
+			if (order == 0)
+				return tab[(int)raw];
+
+			size_t posi = (unsigned int)raw;
+			double frac = raw - (double)posi;
+			if (order == 1)
+			{
+				double a = tab[posi], b = posi < s - 1 ? tab[posi + 1] : tab[0];
+				return a + frac * (b - a);
+			}
+
+			double a = posi > 0 ? tab[posi - 1] : tab[s - 1];
+			double b = tab[posi];
+			double c = posi + 1 < s ? tab[posi + 1] : tab[0];
+			double d = posi + 2 < s ? tab[posi + 2] : tab[posi + 2 - s];
+			double tmp = d + 3.f * b, fracsq = frac * frac, fracb = frac * fracsq;
+			return fracb * (-a - 3.f * c + tmp) / 6.f +
+				fracsq * ((a + c) / 2.f - b) +
+				frac * (c + (-2.f * a - tmp) / 6.f) + b;
+		}
+	};
+
+	template <class Index> using TableRead = TableReader<Index, 0>;
+	template <class Index> using TableReadI = TableReader<Index, 1>;
+	template <class Index> using TableReadC = TableReader<Index, 3>;
+
+	/** Table oscillator, as Osc (order 0), OscI (order 1) and OscC (order 3).
+	*/
+	template <class Amp, class Freq, int order>
+	class Oscillator : public Node<Oscillator<Amp, Freq, order>>
+	{
+	public:
+		/** Oscillator constructor. \n
+			amp - amplitude. \n
+			fr - frequency. \n
+			tab - table to read. \n
+			ph - normalized phase offset. \n
+			dco - DC offset to add. \n
+			sr - sampling rate.
+		*/
+		Oscillator(const Amp& amp, const Freq& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
+			double sr = def_sr) : m_amp(amp), m_tr(Phasor<Freq>(fr, ph, sr), tab), m_dcoff(dco) { };
+
+		void begin(size_t n) { m_amp.begin(n); m_tr.begin(n); }
+		void end() { m_amp.end(); m_tr.end(); }
+		double tick() { double x = m_tr.tick(); return x * m_amp.tick() + m_dcoff; }
+
+	private:
+		Amp m_amp;
+		TableReader<Phasor<Freq>, order> m_tr;
+		double m_dcoff;
+	};
+
+	template <class Amp, class Freq> using Osc = Oscillator<Amp, Freq, 0>;
+	template <class Amp, class Freq> using OscI = Oscillator<Amp, Freq, 1>;
+	template <class Amp, class Freq> using OscC = Oscillator<Amp, Freq, 3>;
+
+	/** Second-order section (Direct Form II), as Iir. Design::update(a, b)
+		computes the coefficients when the parameters change.
+	*/
+	template <class In, class Design>
+	class Biquad : public Node<Biquad<In, Design>>
+	{
+	public:
+		Biquad(const In& in, const Design& design) : m_in(in), m_design(design),
+			m_a{ 0., 0., 0. }, m_b{ 0., 0. }, m_del{ 0., 0. } { };
+
+		void begin(size_t n) { m_in.begin(n); m_design.begin(n); }
+		void end() { m_in.end(); m_design.end(); flushDenormals(m_del, 2); }
+
+		double tick()
+		{
+			double x = m_in.tick();
+			m_design.update(m_a, m_b);
+			double w = x - m_b[0] * m_del[0] - m_b[1] * m_del[1];
+			double y = w * m_a[0] + m_a[1] * m_del[0] + m_a[2] * m_del[1];
+			m_del[1] = m_del[0];
+			m_del[0] = w;
+			return y;
+		}
+
+	private:
+		In m_in;
+		Design m_design;
+		double m_a[3], m_b[2], m_del[2];
+	};
+
+	/** Coefficients of the Butterworth filters with a cutoff frequency,
+		from Kind::coefs(freq, sr, a, b).
+	*/
+	template <class Freq, class Kind>
+	class CutoffDesign
+	{
+	public:
+		CutoffDesign(const Freq& freq, double sr) : m_cutFreq(freq), m_freq(0.), m_sr(sr) { };
+
+		void begin(size_t n) { m_cutFreq.begin(n); }
+		void end() { m_cutFreq.end(); }
+
+		void update(double* a, double* b)
+		{
+			double f = m_cutFreq.tick();
+			if (f != m_freq)
+			{
+				m_freq = f;
+				Kind::coefs(m_freq, m_sr, a, b);
+			}
+		}
+
+	private:
+		Freq m_cutFreq;
+		double m_freq, m_sr;
+	};
+
+	/** Coefficients of the Butterworth filters with a center frequency and
+		a bandwidth, from Kind::coefs(freq, band, sr, a, b).
+	*/
+	template <class Freq, class Band, class Kind>
+	class BandDesign
+	{
+	public:
+		BandDesign(const Freq& freq, const Band& band, double sr) :
+			m_cutFreq(freq), m_band(band), m_freq(0.), m_bw(0.), m_sr(sr) { };
+
+		void begin(size_t n) { m_cutFreq.begin(n); m_band.begin(n); }
+		void end() { m_cutFreq.end(); m_band.end(); }
+
+		void update(double* a, double* b)
+		{
+			double f = m_cutFreq.tick(), bw = m_band.tick();
+			if (f != m_freq || bw != m_bw)
+			{
+				m_freq = f;
+				m_bw = bw;
+				Kind::coefs(m_freq, m_bw, m_sr, a, b);
+			}
+		}
+
+	private:
+		Freq m_cutFreq;
+		Band m_band;
+		double m_freq, m_bw, m_sr;
+	};
+
+	template <class In, class Freq> using LowP = Biquad<In, CutoffDesign<Freq, KiwiWaves::LowP>>;
+	template <class In, class Freq> using HighP = Biquad<In, CutoffDesign<Freq, KiwiWaves::HighP>>;
+	template <class In, class Freq, class Band> using BandP = Biquad<In, BandDesign<Freq, Band, KiwiWaves::BandP>>;
+	template <class In, class Freq, class Band> using BandR = Biquad<In, BandDesign<Freq, Band, KiwiWaves::BandR>>;
+
+	/** First-order filter, as ToneLP and ToneHP. Kind::coefs(freq, sr, a, b)
+		computes the coefficients.
+	*/
+	template <class In, class Freq, class Kind>
+	class OnePole : public Node<OnePole<In, Freq, Kind>>
+	{
+	public:
+		OnePole(const In& in, const Freq& freq, double sr) :
+			m_in(in), m_cutFreq(freq), m_a(0.), m_b(0.), m_freq(0.), m_del(0.), m_sr(sr) { };
+
+		void begin(size_t n) { m_in.begin(n); m_cutFreq.begin(n); }
+		void end() { m_in.end(); m_cutFreq.end(); m_del = flushDenormal(m_del); }
+
+		double tick()
+		{
+			double x = m_in.tick(), f = m_cutFreq.tick();
+			if (f != m_freq)
+			{
+				m_freq = f;
+				Kind::coefs(m_freq, m_sr, m_a, m_b);
+			}
+			m_del = m_a * x - m_b * m_del;
+			return m_del;
+		}
+
+	private:
+		In m_in;
+		Freq m_cutFreq;
+		double m_a, m_b, m_freq, m_del, m_sr;
+	};
+
+	template <class In, class Freq> using ToneLP = OnePole<In, Freq, KiwiWaves::ToneLP>;
+	template <class In, class Freq> using ToneHP = OnePole<In, Freq, KiwiWaves::ToneHP>;
+
+	/** Static chain processed as a dynamic UGen, a vector at a time.
+	*/
+	template <class Chain>
+	class Pipeline : public UGen
+	{
+	public:
+		/** Pipeline constructor. \n
+			chain - the nodes to process, copied. \n
+			vsiz - number of frames in vector. \n
+			sr - sampling rate, the nodes keep their own.
+		*/
+		Pipeline(const Chain& chain, size_t vsiz = def_vsize, double sr = def_sr) :
+			m_chain(chain), UGen(vsiz, sr) { };
+
+		/** Get the chain, to set its parameters.
+		*/
+		Chain& chain() { return m_chain; }
+
+	protected:
+		Chain m_chain;
+
+		void dsp() override { m_chain.render(m_s.data(), m_s.size()); }
+	};
+
+	inline In in(UGen& ugen) { return In(ugen); }
+
+	template <class F>
+	Phasor<ParamOf<F>> phasor(F&& fr, double ph = 0., double sr = def_sr)
+	{
+		return Phasor<ParamOf<F>>(std::forward<F>(fr), ph, sr);
+	}
+
+	template <class I>
+	TableRead<ParamOf<I>> tableRead(I&& index, const FuncTab& tab, bool norm = true, bool wrap = true)
+	{
+		return TableRead<ParamOf<I>>(std::forward<I>(index), tab, norm, wrap);
+	}
+
+	template <class I>
+	TableReadI<ParamOf<I>> tableReadI(I&& index, const FuncTab& tab, bool norm = true, bool wrap = true)
+	{
+		return TableReadI<ParamOf<I>>(std::forward<I>(index), tab, norm, wrap);
+	}
+
+	template <class I>
+	TableReadC<ParamOf<I>> tableReadC(I&& index, const FuncTab& tab, bool norm = true, bool wrap = true)
+	{
+		return TableReadC<ParamOf<I>>(std::forward<I>(index), tab, norm, wrap);
+	}
+
+	template <class A, class F>
+	Osc<ParamOf<A>, ParamOf<F>> osc(A&& amp, F&& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
+		double sr = def_sr)
+	{
+		return Osc<ParamOf<A>, ParamOf<F>>(std::forward<A>(amp), std::forward<F>(fr), tab, ph, dco, sr);
+	}
+
+	template <class A, class F>
+	OscI<ParamOf<A>, ParamOf<F>> oscI(A&& amp, F&& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
+		double sr = def_sr)
+	{
+		return OscI<ParamOf<A>, ParamOf<F>>(std::forward<A>(amp), std::forward<F>(fr), tab, ph, dco, sr);
+	}
+
+	template <class A, class F>
+	OscC<ParamOf<A>, ParamOf<F>> oscC(A&& amp, F&& fr, const FuncTab& tab, double ph = 0., double dco = 0.,
+		double sr = def_sr)
+	{
+		return OscC<ParamOf<A>, ParamOf<F>>(std::forward<A>(amp), std::forward<F>(fr), tab, ph, dco, sr);
+	}
+
+	template <class I, class F>
+	LowP<ParamOf<I>, ParamOf<F>> lowP(I&& in, F&& freq, double sr = def_sr)
+	{
+		return LowP<ParamOf<I>, ParamOf<F>>(std::forward<I>(in),
+			CutoffDesign<ParamOf<F>, KiwiWaves::LowP>(std::forward<F>(freq), sr));
+	}
+
+	template <class I, class F>
+	HighP<ParamOf<I>, ParamOf<F>> highP(I&& in, F&& freq, double sr = def_sr)
+	{
+		return HighP<ParamOf<I>, ParamOf<F>>(std::forward<I>(in),
+			CutoffDesign<ParamOf<F>, KiwiWaves::HighP>(std::forward<F>(freq), sr));
+	}
+
+	template <class I, class F, class B>
+	BandP<ParamOf<I>, ParamOf<F>, ParamOf<B>> bandP(I&& in, F&& freq, B&& band, double sr = def_sr)
+	{
+		return BandP<ParamOf<I>, ParamOf<F>, ParamOf<B>>(std::forward<I>(in),
+			BandDesign<ParamOf<F>, ParamOf<B>, KiwiWaves::BandP>(std::forward<F>(freq), std::forward<B>(band), sr));
+	}
+
+	template <class I, class F, class B>
+	BandR<ParamOf<I>, ParamOf<F>, ParamOf<B>> bandR(I&& in, F&& freq, B&& band, double sr = def_sr)
+	{
+		return BandR<ParamOf<I>, ParamOf<F>, ParamOf<B>>(std::forward<I>(in),
+			BandDesign<ParamOf<F>, ParamOf<B>, KiwiWaves::BandR>(std::forward<F>(freq), std::forward<B>(band), sr));
+	}
+
+	template <class I, class F>
+	ToneLP<ParamOf<I>, ParamOf<F>> toneLP(I&& in, F&& freq, double sr = def_sr)
+	{
+		return ToneLP<ParamOf<I>, ParamOf<F>>(std::forward<I>(in), std::forward<F>(freq), sr);
+	}
+
+	template <class I, class F>
+	ToneHP<ParamOf<I>, ParamOf<F>> toneHP(I&& in, F&& freq, double sr = def_sr)
+	{
+		return ToneHP<ParamOf<I>, ParamOf<F>>(std::forward<I>(in), std::forward<F>(freq), sr);
+	}
+
+	template <class Chain>
+	Pipeline<Chain> pipeline(const Chain& chain, size_t vsiz = def_vsize, double sr = def_sr)
+	{
+		return Pipeline<Chain>(chain, vsiz, sr);
+	}
+}
+
+}
+#endif
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////
+// Stft class: short-time Fourier transform with resynthesis
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _STFT_H_
+#define _STFT_H_
+#include <vector>
+#include "UGen.h"
+#include "Fft.h"
+
+namespace KiwiWaves
+{
+
+/** Short-time Fourier transform analysis and overlap-add resynthesis.
+	Every hop samples a Hann-windowed frame of the input is analysed,
+	passed to processFrame() and resynthesised with the same window.
+	The hop size does not depend on the vector size. \n
+	Without processing, the output is the input delayed by fftSize()
+	samples, exactly for hops of fftSize()/4 or smaller that divide it. \n
+	Spectral effects subclass it and override processFrame().
+*/
+class Stft : public UGen
+{
+public:
+	/** Stft constructor. \n
+		signalIn - input audio signal. \n
+		fftSiz - frame size, rounded up to a power of two. \n
+		hop - hop size (at most the frame size). \n
+		vsiz - number of frames in vector. \n
+		sr - sampling rate.
+	*/
+	Stft(UGen& signalIn, size_t fftSiz = def_fft_size, size_t hop = def_hop_size,
+		size_t vsiz = def_vsize, double sr = def_sr);
+
+	/** Get the frame size.
+	*/
+	size_t fftSize() const { return m_fft.size(); }
+
+	/** Get the hop size.
+	*/
+	size_t hopSize() const { return m_hop; }
+
+	/** Get the number of bins of a spectrum.
+	*/
+	size_t bins() const { return m_fft.size() / 2 + 1; }
+
+	/** Get the latency in samples.
+	*/
+	size_t latency() const { return m_fft.size(); }
+
+	/** Get the real parts of the last analysed spectrum, before processing.
+	*/
+	const double* analysisRe() const { return m_anaRe.data(); }
+
+	/** Get the imaginary parts of the last analysed spectrum, before processing.
+	*/
+	const double* analysisIm() const { return m_anaIm.data(); }
+
+	/** Get the magnitudes of the last analysed spectrum. \n
+		mag - output magnitudes, bins() of them.
+	*/
+	void magnitudes(double* mag) const;
+
+protected:
+	UGen& m_sigIn;
+	Fft m_fft;
+	size_t m_hop;
+
+	void dsp() override;
+
+	/** Process the spectrum of a frame in place before resynthesis. \n
+		re - real parts, bins() of them. \n
+		im - imaginary parts, bins() of them.
+	*/
+	virtual void processFrame(double* /*re*/, double* /*im*/) { }
+
+private:
+	std::vector<double> m_win, m_inBuf, m_acc, m_outBuf, m_time;
+	std::vector<double> m_anaRe, m_anaIm, m_re, m_im;
+	double m_norm;
+	size_t m_fill;
+
+	/** Analyse, process and resynthesise one frame.
+	*/
+	void frame();
+};
+
+}
+
+#endif
@@ -62,10 +62,10 @@ protected:
 
 	void dsp() override;
 
-	/** Get the correct table position taking into
-		consideration normalization, wrapping and clamping.
+	/** Get the correct table position of the index value ind taking
+		into consideration normalization, wrapping and clamping.
 	*/
-	double getRawIndex(const size_t& indx);
+	double getRawIndex(double ind);
 };
 
 /** Table reader with linear interpolation.
@@ -48,6 +48,14 @@ public:
 	void setCutFreq(double val) { m_cutFreq.set(val); update(); }
 	void setCutFreq(UGen& modulator) { m_cutFreq.set(modulator); update(); }
 
+	/** Compute the filter coefficients, y = a * x - b * y(n-1). \n
+		freq - cutoff frequency. \n
+		sr - sampling rate. \n
+		a - output input coefficient. \n
+		b - output feedback coefficient.
+	*/
+	static void coefs(double freq, double sr, double& a, double& b);
+
 protected:
 	UGen& m_sigIn;
 	UGenParam m_cutFreq;
@@ -83,6 +91,14 @@ public:
 	ToneHP(UGen& signalIn, double cutFreq, size_t vsiz = def_vsize, double sr = def_sr) :
 		ToneLP(signalIn, cutFreq, vsiz, sr) { };
 
+	/** Compute the filter coefficients, y = a * x - b * y(n-1). \n
+		freq - cutoff frequency. \n
+		sr - sampling rate. \n
+		a - output input coefficient. \n
+		b - output feedback coefficient.
+	*/
+	static void coefs(double freq, double sr, double& a, double& b);
+
 protected:
 	void update() override;
 };
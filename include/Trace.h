@@ -0,0 +1,86 @@
+/////////////////////////////////////////////////////////////////////
+// Trace: per-thread timeline of blocks and UGen processing
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _TRACE_H_
+#define _TRACE_H_
+#include <ostream>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+class UGen;
+
+/** Timeline tracer, compiled in when KIWIWAVES_TRACE is defined (the
+	KIWIWAVES_TRACE CMake option). UGen::process() then records a begin
+	and an end event around every dsp() call, and the code driving the
+	graph marks its blocks with Trace::Block. \n
+	Every thread writes to its own ring of def_trace_capacity events,
+	without locks, and the oldest events are overwritten when it is full.
+	The rings are only locked when a thread records its first event. \n
+	Trace::write() exports the rings as Chrome trace JSON, which can be
+	opened in chrome://tracing or Perfetto. It has to be called when
+	no thread is recording.
+*/
+namespace Trace
+{
+	/** Record the start of the processing of a UGen.
+	*/
+	void begin(const UGen& ugen);
+
+	/** Record the end of the processing of a UGen.
+	*/
+	void end(const UGen& ugen);
+
+	/** Record the start of a named span, like a block. \n
+		name - string literal, only its address is stored.
+	*/
+	void begin(const char* name);
+
+	/** Record the end of a named span.
+	*/
+	void end(const char* name);
+
+	/** Name the calling thread in the exported trace.
+	*/
+	void setThreadName(const char* name);
+
+	/** Enable or disable the recording, enabled by default.
+	*/
+	void enable(bool on);
+
+	/** Drop the events recorded by every thread.
+	*/
+	void clear();
+
+	/** Write the recorded events as Chrome trace JSON.
+	*/
+	void write(std::ostream& os);
+
+	/** Span of a block, from its construction to its destruction.
+	*/
+	class Block
+	{
+	public:
+		/** Block constructor. \n
+			name - string literal shown on the timeline.
+		*/
+		Block(const char* name = "block") : m_name(name) { begin(m_name); };
+
+		~Block() { end(m_name); };
+
+	private:
+		const char* m_name;
+	};
+}
+
+}
+#endif
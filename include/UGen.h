@@ -13,6 +13,9 @@
 #define _UGEN_H_
 #include <vector>
 #include "KiwiWaves.h"
+#ifdef KIWIWAVES_PROFILE
+#include "Profile.h"
+#endif
 
 namespace KiwiWaves
 {
@@ -51,6 +54,16 @@ public:
 	*/
 	virtual const double& operator [](const size_t& idx) const;
 
+#ifdef KIWIWAVES_PROFILE
+	/** Get the processing counters.
+	*/
+	const Profile::Counters& profile() const { return m_prof; }
+
+	/** Set the processing counters to zero.
+	*/
+	void resetProfile() { m_prof.reset(); }
+#endif
+
 	virtual const UGen& operator+=(const UGen& other);
 	virtual const UGen operator+(const UGen& other) const;
 	virtual const UGen& operator+=(const double& val);
@@ -78,6 +91,9 @@ public:
 protected:
 	double m_sr;
 	std::vector<double> m_s;
+#ifdef KIWIWAVES_PROFILE
+	Profile::Counters m_prof;
+#endif
 
 	/** Kernel dsp method that each UGen will override.
 	*/
@@ -91,6 +107,11 @@ protected:
 	*/
 	void fillDataToOne();
 
+	/** Process a UGen that is a member of this one, without timing it
+		separately when profiling, so that its time is counted in this one.
+	*/
+	static void processMember(UGen& member) { member.dsp(); }
+
 protected:
 
 	/** Auxiliar class for UGen parameters that can be modulated.
@@ -117,6 +138,22 @@ protected:
 		*/
 		inline void set(UGen& modulator) { m_FixedValue = 0.; m_Modulator = &modulator; }
 
+		/** True if the parameter is modulated by a UGen.
+		*/
+		inline bool modulated() const { return m_Modulator != nullptr; }
+
+		/** Get the end of the run of equal values that starts at position
+			start, at most n (n if no modulation).
+		*/
+		inline size_t runEnd(size_t start, size_t n) const
+		{
+			if (m_Modulator == nullptr) return n;
+			const double* val = m_Modulator->data();
+			size_t end = start + 1;
+			while (end < n && val[end] == val[start]) end++;
+			return end;
+		}
+
 		/** Get the control rate value of the parameter,
 			will be the first value of the vector in case of modulation.
 		*/
@@ -127,6 +164,23 @@ protected:
 		*/
 		inline const double& operator [](const size_t& idx) const { return m_Modulator ? (*m_Modulator)[idx] : m_FixedValue; }
 
+		/** Values of the parameter over one vector, as a pointer and a stride:
+			the modulator's data with stride 1, or the fixed value with stride 0.
+		*/
+		struct Block
+		{
+			const double* ptr;
+			size_t stride;
+
+			inline const double& operator [](size_t idx) const { return ptr[idx * stride]; }
+		};
+
+		/** Get the values of the parameter over the current vector, so that
+			a kernel can test for modulation once per vector and run branch-free
+			loops on a raw pointer.
+		*/
+		inline Block block() const { return m_Modulator ? Block{ m_Modulator->data(), 1 } : Block{ &m_FixedValue, 0 }; }
+
 	private:
 		double m_FixedValue;
 		UGen* m_Modulator;
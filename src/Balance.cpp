@@ -10,27 +10,58 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "Balance.h"
+#include "Denormals.h"
 
 using namespace KiwiWaves;
 
-void Balance::dsp()
+template <ZeroHandlingMode mode>
+void Balance::applyGain()
 {
-    m_rmsSig.process();
-    m_rmsComp.process();
+    const double* in = m_sigIn.data();
+    const double* sig = m_rmsSig.data();
+    const double* comp = m_rmsComp.data();
 
     for (size_t i = 0; i < m_s.size(); i++)
     {
-        switch (m_zeroHandling)
+        // Both estimates are loaded unconditionally so the selects are branch-free
+        double s = sig[i], c = comp[i], num, den;
+        if (mode == equalToOne)
+        {
+            num = s > 0. ? c : 1.;
+            den = s > 0. ? s : 1.;
+        }
+        else
         {
-        case addSmallNumber:
-            m_s[i] = m_sigIn[i] * (m_rmsComp[i] / (m_rmsSig[i] > 0. ? m_rmsSig[i] : min_double));
-            break;
-        case equalToOne:
-            m_s[i] = m_sigIn[i] * (m_rmsSig[i] > 0. ? m_rmsComp[i] / m_rmsSig[i] : 1.);
-            break;
-        default:
-            // Default is addSmallNumber
-            m_s[i] = m_sigIn[i] * (m_rmsComp[i] / (m_rmsSig[i] > 0. ? m_rmsSig[i] : min_double));
+            num = c;
+            den = s > 0. ? s : min_double;
         }
+        m_s[i] = in[i] * (num / den);
     }
 }
+
+void Balance::dsp()
+{
+    const double* in = m_sigIn.data();
+    const double* comp = m_sigComp.data();
+    size_t n = m_s.size();
+
+    for (size_t start = 0, end; start < n; start = end)
+    {
+        end = m_cutFreq.runEnd(start, n);
+        if (m_freq != m_cutFreq[start])
+        {
+            m_freq = m_cutFreq[start];
+            ToneLP::coefs(m_freq, m_sr, m_a, m_b);
+        }
+        Rms::processPair(in + start, comp + start, m_rmsSig.data() + start, m_rmsComp.data() + start,
+            end - start, m_a, m_b, m_delSig, m_delComp);
+    }
+    m_delSig = flushDenormal(m_delSig);
+    m_delComp = flushDenormal(m_delComp);
+
+    // Default is addSmallNumber
+    if (m_zeroHandling == equalToOne)
+        applyGain<equalToOne>();
+    else
+        applyGain<addSmallNumber>();
+}
@@ -24,25 +24,41 @@ bool LowP::prepareUpdate(const size_t& indx)
 }
 
 void LowP::update() {
-    double l = 1 / tan(pi * m_freq / m_sr);
+    if (m_coefTab) m_coefTab->lookup(m_freq, 0., m_a, m_b, m_scal);
+    else coefs(m_freq, m_sr, m_a, m_b);
+}
+
+void LowP::useCoefTable(bool use) {
+    if (use) m_coefTab = CoefTable::get(design(), m_sr);
+    else m_coefTab.reset();
+    update();
+}
+
+void LowP::coefs(double freq, double sr, double* a, double* b) {
+    double l = 1 / tan(pi * freq / sr);
     double sqrt2l = sqrt(2.) * l;
     double lsq = l * l;
-    m_a[0] = 1. / (1. + sqrt2l + lsq);
-    m_a[1] = 2. * m_a[0];
-    m_a[2] = m_a[0];
-    m_b[0] = 2. * (1. - lsq) * m_a[0];
-    m_b[1] = (1. - sqrt2l + lsq) * m_a[0];
+    a[0] = 1. / (1. + sqrt2l + lsq);
+    a[1] = 2. * a[0];
+    a[2] = a[0];
+    b[0] = 2. * (1. - lsq) * a[0];
+    b[1] = (1. - sqrt2l + lsq) * a[0];
 }
 
 void HighP::update() {
-    double l = tan(pi * m_freq / m_sr);
+    if (m_coefTab) m_coefTab->lookup(m_freq, 0., m_a, m_b, m_scal);
+    else coefs(m_freq, m_sr, m_a, m_b);
+}
+
+void HighP::coefs(double freq, double sr, double* a, double* b) {
+    double l = tan(pi * freq / sr);
     double sqrt2l = sqrt(2.) * l;
     double lsq = l * l;
-    m_a[0] = 1. / (1. + sqrt2l + lsq);
-    m_a[1] = -2. * m_a[0];
-    m_a[2] = m_a[0];
-    m_b[0] = 2. * (lsq - 1.) * m_a[0];
-    m_b[1] = (1. - sqrt2l + lsq) * m_a[0];
+    a[0] = 1. / (1. + sqrt2l + lsq);
+    a[1] = -2. * a[0];
+    a[2] = a[0];
+    b[0] = 2. * (lsq - 1.) * a[0];
+    b[1] = (1. - sqrt2l + lsq) * a[0];
 }
 
 bool BandP::prepareUpdate(const size_t& indx)
@@ -57,21 +73,31 @@ bool BandP::prepareUpdate(const size_t& indx)
 }
 
 void BandP::update() {
-    double l = 1. / tan(pi * m_bw / m_sr);
-    double cosl = 2. * cos(2 * pi * m_freq / m_sr);
-    m_a[0] = 1. / (1. + l);
-    m_a[1] = 0;
-    m_a[2] = -m_a[0];
-    m_b[0] = -l * cosl * m_a[0];
-    m_b[1] = (l - 1.) * m_a[0];
+    if (m_coefTab) m_coefTab->lookup(m_freq, m_bw, m_a, m_b, m_scal);
+    else coefs(m_freq, m_bw, m_sr, m_a, m_b);
+}
+
+void BandP::coefs(double freq, double band, double sr, double* a, double* b) {
+    double l = 1. / tan(pi * band / sr);
+    double cosl = 2. * cos(2 * pi * freq / sr);
+    a[0] = 1. / (1. + l);
+    a[1] = 0;
+    a[2] = -a[0];
+    b[0] = -l * cosl * a[0];
+    b[1] = (l - 1.) * a[0];
 }
 
 void BandR::update() {
-    double l = tan(pi * m_bw / m_sr);
-    double cosl = 2. * cos(2 * pi * m_freq / m_sr);
-    m_a[0] = 1. / (1. + l);
-    m_a[1] = -cosl * m_a[0];
-    m_a[2] = m_a[0];
-    m_b[0] = m_a[1];
-    m_b[1] = (1. - l) * m_a[0];
+    if (m_coefTab) m_coefTab->lookup(m_freq, m_bw, m_a, m_b, m_scal);
+    else coefs(m_freq, m_bw, m_sr, m_a, m_b);
+}
+
+void BandR::coefs(double freq, double band, double sr, double* a, double* b) {
+    double l = tan(pi * band / sr);
+    double cosl = 2. * cos(2 * pi * freq / sr);
+    a[0] = 1. / (1. + l);
+    a[1] = -cosl * a[0];
+    a[2] = a[0];
+    b[0] = a[1];
+    b[1] = (1. - l) * a[0];
 }
\ No newline at end of file
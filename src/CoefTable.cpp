@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the CoefTable class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+#include "CoefTable.h"
+#include "Butterworth.h"
+#include "Reson.h"
+
+using namespace KiwiWaves;
+
+namespace
+{
+    /** Normalized frequencies are kept away from 0 and Nyquist
+        when designing, where some of the designs are singular.
+    */
+    const double min_norm_freq = 1e-7;
+
+    void lowPassDesign_(double freq, double, double sr, double* a, double* b, double& scal)
+    {
+        LowP::coefs(freq, sr, a, b);
+        scal = 1.;
+    }
+
+    void highPassDesign_(double freq, double, double sr, double* a, double* b, double& scal)
+    {
+        HighP::coefs(freq, sr, a, b);
+        scal = 1.;
+    }
+
+    void bandPassDesign_(double freq, double band, double sr, double* a, double* b, double& scal)
+    {
+        BandP::coefs(freq, band, sr, a, b);
+        scal = 1.;
+    }
+
+    void bandRejectDesign_(double freq, double band, double sr, double* a, double* b, double& scal)
+    {
+        BandR::coefs(freq, band, sr, a, b);
+        scal = 1.;
+    }
+
+    void resonDesign_(double freq, double band, double sr, double* a, double* b, double& scal)
+    {
+        ResonR::coefs(freq, band, sr, a, b, scal);
+    }
+}
+
+CoefTable::CoefTable(Design design, bool useBand, double sr, size_t fsiz, size_t bsiz) :
+    m_fsiz(fsiz < 2 ? 2 : fsiz), m_bsiz(useBand ? (bsiz < 2 ? 2 : bsiz) : 1), m_sr(sr), m_twoInvSr(2. / sr)
+{
+    m_coefs.resize(m_fsiz * m_bsiz * 6);
+    double u, freq, band = 0.;
+    for (size_t j = 0; j < m_bsiz; j++)
+    {
+        if (useBand)
+        {
+            u = (double)j / (m_bsiz - 1);
+            band = std::min(std::max(0.5 * u * u, min_norm_freq), 0.5 - min_norm_freq) * sr;
+        }
+
+        for (size_t i = 0; i < m_fsiz; i++)
+        {
+            u = (double)i / (m_fsiz - 1);
+            freq = std::min(std::max(0.5 * u * u, min_norm_freq), 0.5 - min_norm_freq) * sr;
+            double* c = &m_coefs[(j * m_fsiz + i) * 6];
+            design(freq, band, sr, c, c + 3, c[5]);
+        }
+    }
+}
+
+std::shared_ptr<const CoefTable> CoefTable::get(FilterDesign design, double sr)
+{
+    static std::mutex lock;
+    static std::map<std::pair<int, double>, std::weak_ptr<const CoefTable>> tables;
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::weak_ptr<const CoefTable>& entry = tables[std::make_pair((int)design, sr)];
+    std::shared_ptr<const CoefTable> table = entry.lock();
+    if (table) return table;
+
+    switch (design)
+    {
+    case lowPassDesign:
+        table = std::make_shared<const CoefTable>(lowPassDesign_, false, sr);
+        break;
+    case highPassDesign:
+        table = std::make_shared<const CoefTable>(highPassDesign_, false, sr);
+        break;
+    case bandPassDesign:
+        table = std::make_shared<const CoefTable>(bandPassDesign_, true, sr);
+        break;
+    case bandRejectDesign:
+        table = std::make_shared<const CoefTable>(bandRejectDesign_, true, sr);
+        break;
+    case resonDesign:
+    default:
+        table = std::make_shared<const CoefTable>(resonDesign_, true, sr);
+    }
+
+    entry = table;
+    return table;
+}
+
+void CoefTable::position(double freq, size_t siz, size_t& pos, double& frac) const
+{
+    double x = freq * m_twoInvSr;
+    x = x < 0. ? 0. : (x > 1. ? 1. : x);
+    double raw = std::sqrt(x) * (double)(siz - 1);
+    pos = (size_t)raw;
+    if (pos >= siz - 1) pos = siz - 2;
+    frac = raw - (double)pos;
+}
+
+void CoefTable::lookup(double freq, double band, double* a, double* b, double& scal) const
+{
+    size_t fi, bi = 0;
+    double ff, bf = 0.;
+    position(freq, m_fsiz, fi, ff);
+    if (m_bsiz > 1) position(band, m_bsiz, bi, bf);
+
+    const double* c00 = &m_coefs[(bi * m_fsiz + fi) * 6];
+    const double* c01 = c00 + 6;
+    const double* c10 = m_bsiz > 1 ? c00 + m_fsiz * 6 : c00;
+    const double* c11 = c10 + 6;
+
+    double c[6], lo, hi;
+    for (size_t k = 0; k < 6; k++)
+    {
+        lo = c00[k] + ff * (c01[k] - c00[k]);
+        hi = c10[k] + ff * (c11[k] - c10[k]);
+        c[k] = lo + bf * (hi - lo); // bilinear interpolation
+    }
+
+    a[0] = c[0]; a[1] = c[1]; a[2] = c[2];
+    b[0] = c[3]; b[1] = c[4];
+    scal = c[5];
+}
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Convolver class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Convolver.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+namespace
+{
+    size_t powerOfTwo(size_t n)
+    {
+        size_t siz = 2;
+        while (siz < n) siz <<= 1;
+        return siz;
+    }
+
+    std::vector<double> copyTable(const FuncTab& ir, size_t irLen)
+    {
+        size_t len = irLen > 0 && irLen < ir.size() ? irLen : ir.size();
+        std::vector<double> v(len);
+        for (size_t i = 0; i < len; i++)
+            v[i] = ir[i];
+        return v;
+    }
+}
+
+Convolver::Convolver(UGen& signalIn, const FuncTab& ir, size_t irLen, bool zeroLatency,
+    size_t bsiz, size_t vsiz, double sr) :
+    m_sigIn(signalIn), m_block(powerOfTwo(bsiz)), m_zeroLat(zeroLatency), m_fft(2 * m_block),
+    m_pending(nullptr), m_retired(nullptr), m_preparing(false),
+    m_inBuf(2 * m_block, 0.), m_outBuf(m_block, 0.), m_time(2 * m_block, 0.),
+    m_accRe(m_block + 1, 0.), m_accIm(m_block + 1, 0.), m_hist(m_block - 1 + vsiz, 0.),
+    m_fill(0), m_fdlPos(0), UGen(vsiz, sr)
+{
+    m_kernel.reset(prepare(copyTable(ir, irLen), m_block, m_zeroLat));
+}
+
+Convolver::~Convolver()
+{
+    if (m_loader.joinable()) m_loader.join();
+    delete m_pending.exchange(nullptr);
+    delete m_retired.exchange(nullptr);
+}
+
+void Convolver::setIR(const FuncTab& ir, size_t irLen, bool async)
+{
+    if (m_loader.joinable()) m_loader.join();
+    delete m_retired.exchange(nullptr);
+
+    // The table is copied now, so it does not have to outlive the call
+    std::vector<double> v = copyTable(ir, irLen);
+    if (!async)
+    {
+        delete m_pending.exchange(prepare(v, m_block, m_zeroLat));
+        return;
+    }
+
+    m_preparing = true;
+    m_loader = std::thread([this, v]() {
+        delete m_pending.exchange(prepare(v, m_block, m_zeroLat));
+        m_preparing = false;
+    });
+}
+
+Convolver::Kernel* Convolver::prepare(const std::vector<double>& ir, size_t bsiz, bool zeroLatency)
+{
+    Kernel* k = new Kernel;
+    size_t start = zeroLatency ? std::min(bsiz, ir.size()) : 0;
+    k->head.assign(ir.begin(), ir.begin() + start);
+    k->parts = (ir.size() - start + bsiz - 1) / bsiz;
+
+    size_t bins = bsiz + 1;
+    k->re.resize(k->parts * bins);
+    k->im.resize(k->parts * bins);
+    k->fdlRe.assign(k->parts * bins, 0.);
+    k->fdlIm.assign(k->parts * bins, 0.);
+
+    // Each partition zero-padded to twice its size
+    Fft fft(2 * bsiz);
+    std::vector<double> buf(2 * bsiz);
+    for (size_t p = 0; p < k->parts; p++)
+    {
+        std::fill(buf.begin(), buf.end(), 0.);
+        size_t first = start + p * bsiz;
+        size_t n = std::min(bsiz, ir.size() - first);
+        std::copy(ir.begin() + first, ir.begin() + first + n, buf.begin());
+        fft.forward(buf.data(), &k->re[p * bins], &k->im[p * bins]);
+    }
+    return k;
+}
+
+void Convolver::partition()
+{
+    Kernel& k = *m_kernel;
+    size_t bins = m_block + 1;
+
+    if (k.parts > 0)
+    {
+        // Newest input spectrum into the frequency-domain delay line
+        double* xr = &k.fdlRe[m_fdlPos * bins];
+        double* xi = &k.fdlIm[m_fdlPos * bins];
+        m_fft.forward(m_inBuf.data(), xr, xi);
+
+        std::fill(m_accRe.begin(), m_accRe.end(), 0.);
+        std::fill(m_accIm.begin(), m_accIm.end(), 0.);
+        double* yr = m_accRe.data();
+        double* yi = m_accIm.data();
+        for (size_t p = 0; p < k.parts; p++)
+        {
+            size_t slot = (m_fdlPos + k.parts - p) % k.parts;
+            xr = &k.fdlRe[slot * bins];
+            xi = &k.fdlIm[slot * bins];
+            const double* hr = &k.re[p * bins];
+            const double* hi = &k.im[p * bins];
+            for (size_t b = 0; b < bins; b++)
+            {
+                yr[b] += xr[b] * hr[b] - xi[b] * hi[b];
+                yi[b] += xr[b] * hi[b] + xi[b] * hr[b];
+            }
+        }
+        m_fdlPos = (m_fdlPos + 1) % k.parts;
+
+        // Overlap-save: only the second half is free of circular aliasing
+        m_fft.inverse(yr, yi, m_time.data());
+        std::memcpy(m_outBuf.data(), m_time.data() + m_block, m_block * sizeof(double));
+    }
+    else
+    {
+        std::fill(m_outBuf.begin(), m_outBuf.end(), 0.);
+    }
+
+    std::memcpy(m_inBuf.data(), m_inBuf.data() + m_block, m_block * sizeof(double));
+}
+
+void Convolver::dsp()
+{
+    // Swap in a new impulse response once the previous one has been released
+    if (m_retired.load() == nullptr)
+    {
+        Kernel* k = m_pending.exchange(nullptr);
+        if (k != nullptr)
+        {
+            m_retired.store(m_kernel.release());
+            m_kernel.reset(k);
+            m_fdlPos = 0;
+        }
+    }
+
+    const double* in = m_sigIn.data();
+    size_t vsiz = m_s.size();
+
+    // Time-domain head, read from the last inputs followed by the current vector
+    std::fill(m_s.begin(), m_s.end(), 0.);
+    if (m_zeroLat)
+    {
+        const std::vector<double>& head = m_kernel->head;
+        std::memcpy(m_hist.data() + m_block - 1, in, vsiz * sizeof(double));
+        const double* x = m_hist.data() + m_block - 1;
+        for (size_t j = 0; j < head.size(); j++)
+        {
+            double h = head[j];
+            for (size_t i = 0; i < vsiz; i++)
+                m_s[i] += h * x[(ptrdiff_t)i - (ptrdiff_t)j];
+        }
+
+        if (vsiz >= m_block - 1)
+            std::memcpy(m_hist.data(), in + vsiz - (m_block - 1), (m_block - 1) * sizeof(double));
+        else
+            std::memmove(m_hist.data(), m_hist.data() + vsiz, (m_block - 1) * sizeof(double));
+    }
+
+    // Partitioned part, one partition behind the input
+    for (size_t pos = 0; pos < vsiz;)
+    {
+        size_t n = std::min(m_block - m_fill, vsiz - pos);
+        std::memcpy(m_inBuf.data() + m_block + m_fill, in + pos, n * sizeof(double));
+        for (size_t i = 0; i < n; i++)
+            m_s[pos + i] += m_outBuf[m_fill + i];
+
+        m_fill += n;
+        pos += n;
+        if (m_fill == m_block)
+        {
+            partition();
+            m_fill = 0;
+        }
+    }
+}
@@ -11,46 +11,131 @@
 /////////////////////////////////////////////////////////////////////
 #include "Delay.h"
 #include "Comb.h"
+#include "Denormals.h"
+#include <algorithm>
+#include <cstring>
 
 using namespace KiwiWaves;
 
 void Delay::dsp()
 {
-    double delSample;
-    double a, b;
-    double readPos;
-    size_t readPosI;
-    for (size_t i = 0; i < m_s.size(); i++)
+    UGenParam::Block del = m_delVal.block();
+    bool gain = gainFb();
+
+    if (del.stride == 0)
     {
-        delSample = (m_delVal[i] < 0. ? 0. : m_delVal[i] * m_sr);
-        if (delSample > (double)m_delLine.size())
-            delSample = (double)m_delLine.size();
+        double delSample = del[0] < 0. ? 0. : (del[0] * m_sr > m_maxDel ? m_maxDel : del[0] * m_sr);
+        size_t readOffs = delSample > 0. ? (size_t)std::ceil(delSample) : (size_t)m_maxDel;
+        double frac = m_interp ? (double)readOffs - delSample : 0.;
 
-        readPos = (double)m_writePos - delSample;
-        if (readPos < 0.)
-            readPos += (double)m_delLine.size();
+        // The whole block is read before any of it gets overwritten
+        if (readOffs >= m_s.size() + (frac > 0. ? 1 : 0))
+            dspFixed(readOffs, frac);
+        else if (gain)
+            dspSamples<false, true>(del);
+        else
+            dspSamples<false, false>(del);
+    }
+    else if (gain)
+        dspSamples<true, true>(del);
+    else
+        dspSamples<true, false>(del);
+}
 
-        readPosI = (size_t)readPos < m_delLine.size()-1 ? (size_t)readPos : m_delLine.size()-1;
+template <bool modDel, bool gain>
+void Delay::dspSamples(UGenParam::Block del)
+{
+    size_t n = m_s.size(), readOffs = 0, readPosI;
+    double delSample = 0., a, b;
+    const double* in = m_sigIn.data();
+    double* out = m_s.data();
+    double* line = m_delLine.data();
+    UGenParam::Block fb = m_fb.block();
+
+    if (!modDel)
+    {
+        delSample = del[0] < 0. ? 0. : (del[0] * m_sr > m_maxDel ? m_maxDel : del[0] * m_sr);
+        readOffs = delSample > 0. ? (size_t)std::ceil(delSample) : (size_t)m_maxDel;
+    }
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (modDel)
+        {
+            delSample = (del.ptr[i] < 0. ? 0. : del.ptr[i] * m_sr);
+            if (delSample > m_maxDel)
+                delSample = m_maxDel;
+
+            // A zero delay reads the oldest sample, as a full-length delay
+            readOffs = delSample > 0. ? (size_t)std::ceil(delSample) : (size_t)m_maxDel;
+        }
+        readPosI = (m_writePos - readOffs) & m_mask;
 
         if (m_interp)
         {
-            a = m_delLine[readPosI];
-            b = readPosI < m_delLine.size() - 1 ? m_delLine[readPosI + 1] : m_delLine[0];
-            m_s[i] = a + (readPos - (double)readPosI) * (b - a); // linear interpolation
+            a = line[readPosI];
+            b = line[(readPosI + 1) & m_mask];
+            out[i] = a + ((double)readOffs - delSample) * (b - a); // linear interpolation
         }
         else
         {
-            m_s[i] = m_delLine[readPosI]; // no interp
+            out[i] = line[readPosI]; // no interp
         }
 
-        m_delLine[m_writePos] = m_sigIn[i] + getFb(i);
-        m_writePos = m_writePos >= m_delLine.size() - 1 ? 0 : m_writePos + 1;
+        line[m_writePos] = in[i] + (gain ? flushDenormal(out[i] * fb[i]) : getFb(i));
+        m_writePos = (m_writePos + 1) & m_mask;
     }
 }
 
+void Delay::dspFixed(size_t readOffs, double frac)
+{
+    size_t vsiz = m_s.size(), lsiz = m_delLine.size();
+    size_t readPos = (m_writePos - readOffs) & m_mask;
+    size_t first = std::min(vsiz, lsiz - readPos);
+    double* line = m_delLine.data();
+    double* out = m_s.data();
+
+    if (frac == 0.)
+    {
+        std::memcpy(out, line + readPos, first * sizeof(double));
+        std::memcpy(out + first, line, (vsiz - first) * sizeof(double));
+    }
+    else
+    {
+        for (size_t i = 0; i < vsiz; i++)
+        {
+            double a = line[(readPos + i) & m_mask];
+            out[i] = a + frac * (line[(readPos + i + 1) & m_mask] - a); // linear interpolation
+        }
+    }
+
+    // Without feedback the input is copied as is (a zero RT60 also means no feedback in Comb)
+    first = std::min(vsiz, lsiz - m_writePos);
+    if (!m_fb.modulated() && m_fb[0] == 0.)
+    {
+        const double* in = m_sigIn.data();
+        std::memcpy(line + m_writePos, in, first * sizeof(double));
+        std::memcpy(line, in + first, (vsiz - first) * sizeof(double));
+    }
+    else if (gainFb())
+    {
+        const double* in = m_sigIn.data();
+        UGenParam::Block fb = m_fb.block();
+        for (size_t i = 0; i < vsiz; i++)
+            line[(m_writePos + i) & m_mask] = in[i] + flushDenormal(out[i] * fb[i]);
+    }
+    else
+    {
+        const double* in = m_sigIn.data();
+        for (size_t i = 0; i < vsiz; i++)
+            line[(m_writePos + i) & m_mask] = in[i] + getFb(i);
+    }
+    m_writePos = (m_writePos + vsiz) & m_mask;
+}
+
 double Delay::getFb(size_t pos)
 {
-    return m_s[pos] * m_fb[pos];
+    return flushDenormal(m_s[pos] * m_fb[pos]);
 }
 
 double Comb::getFb(size_t pos)
@@ -60,8 +145,13 @@ double Comb::getFb(size_t pos)
         // in the Comb class, m_fb is used to store the RT60 values instead of the feedback
         m_currentRT60 = m_fb[pos]; 
         m_currentDel = m_delVal[pos];
-        m_currentFb = pow(0.001, m_currentDel / m_currentRT60);
+        m_currentFb = fbFromRT60(m_currentDel, m_currentRT60);
     }
 
-    return m_s[pos] * m_currentFb;
+    return flushDenormal(m_s[pos] * m_currentFb);
+}
+
+double Comb::fbFromRT60(double del, double rt60)
+{
+    return pow(0.001, del / rt60);
 }
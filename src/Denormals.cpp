@@ -0,0 +1,64 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the DenormalScope class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Denormals.h"
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KIWIWAVES_DENORMALS_MXCSR
+#elif defined(__aarch64__)
+#define KIWIWAVES_DENORMALS_FPCR
+#endif
+
+using namespace KiwiWaves;
+
+#if defined(KIWIWAVES_DENORMALS_MXCSR)
+// Flush-to-zero (bit 15) and denormals-are-zero (bit 6) of MXCSR
+static const uint64_t ftz_bits = 0x8040;
+
+static uint64_t getMode() { return _mm_getcsr(); }
+static void setMode(uint64_t mode) { _mm_setcsr((unsigned int)mode); }
+#elif defined(KIWIWAVES_DENORMALS_FPCR)
+// Flush-to-zero (bit 24) of FPCR, which also flushes the operands
+static const uint64_t ftz_bits = 1ULL << 24;
+
+static uint64_t getMode()
+{
+    uint64_t mode;
+    __asm__ __volatile__("mrs %0, fpcr" : "=r"(mode));
+    return mode;
+}
+static void setMode(uint64_t mode) { __asm__ __volatile__("msr fpcr, %0" : : "r"(mode)); }
+#else
+static const uint64_t ftz_bits = 0;
+
+static uint64_t getMode() { return 0; }
+static void setMode(uint64_t) { }
+#endif
+
+DenormalScope::DenormalScope(bool enable) : m_enabled(enable), m_saved(0)
+{
+    if (m_enabled)
+    {
+        m_saved = getMode();
+        setMode(m_saved | ftz_bits);
+    }
+}
+
+DenormalScope::~DenormalScope()
+{
+    if (m_enabled)
+        setMode(m_saved);
+}
+
+bool DenormalScope::active()
+{
+    return ftz_bits != 0 && (getMode() & ftz_bits) == ftz_bits;
+}
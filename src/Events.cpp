@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the EventQueue class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Events.h"
+
+using namespace KiwiWaves;
+
+bool EventQueue::push(size_t offset, EventType type, double value)
+{
+    if (m_size == def_event_capacity)
+        return false;
+
+    // Insertion after the events at the same or earlier offsets
+    size_t pos = m_size;
+    while (pos > 0 && m_events[pos - 1].offset > offset)
+    {
+        m_events[pos] = m_events[pos - 1];
+        pos--;
+    }
+    m_events[pos] = { offset, type, value };
+    m_size++;
+    return true;
+}
+
+void EventQueue::pop()
+{
+    if (m_size == 0)
+        return;
+
+    for (size_t i = 1; i < m_size; i++)
+        m_events[i - 1] = m_events[i];
+    m_size--;
+}
+
+void EventQueue::advance(size_t n)
+{
+    // Events left behind are late, they happen at the start of the next vector
+    for (size_t i = 0; i < m_size; i++)
+        m_events[i].offset = m_events[i].offset > n ? m_events[i].offset - n : 0;
+}
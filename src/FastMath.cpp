@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the FastMath block functions and precision mode
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <atomic>
+#include "FastMath.h"
+
+using namespace KiwiWaves;
+
+namespace
+{
+    std::atomic<uint8_t> mathPrecision(preciseMath);
+}
+
+void KiwiWaves::setMathPrecision(MathPrecision prec)
+{
+    mathPrecision.store(prec, std::memory_order_relaxed);
+}
+
+MathPrecision KiwiWaves::getMathPrecision()
+{
+    return (MathPrecision)mathPrecision.load(std::memory_order_relaxed);
+}
+
+void FastMath::sin(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::sin(in[i]);
+}
+
+void FastMath::cos(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::cos(in[i]);
+}
+
+void FastMath::tan(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::tan(in[i]);
+}
+
+void FastMath::exp(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::exp(in[i]);
+}
+
+void FastMath::log(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::log(in[i]);
+}
+
+void FastMath::acos(const double* in, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::acos(in[i]);
+}
+
+void FastMath::pow(const double* in, double y, double* out, size_t n)
+{
+    // Branch-free pass for positive bases, then fix the rest up
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::exp(y * FastMath::log(in[i]));
+
+    for (size_t i = 0; i < n; i++)
+        if (!(in[i] > 0.)) out[i] = std::pow(in[i], y);
+}
+
+void FastMath::atan2(const double* y, const double* x, double* out, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        out[i] = FastMath::atan2(y[i], x[i]);
+}
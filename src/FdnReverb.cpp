@@ -0,0 +1,190 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the FdnReverb class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "FdnReverb.h"
+#include "Comb.h"
+#include "Tone.h"
+#include "Denormals.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+namespace
+{
+    // Range of the delay line lengths, in seconds
+    const double fdn_min_del = 0.0297;
+    const double fdn_max_del = 0.0797;
+
+    bool isPrime(size_t n)
+    {
+        if (n < 2) return false;
+        for (size_t d = 2; d * d <= n; d++)
+            if (n % d == 0) return false;
+        return true;
+    }
+}
+
+void FdnReverb::init(size_t lines)
+{
+    size_t n = lines > 0 ? lines : 1;
+    if (m_matrix == hadamardMatrix)
+    {
+        size_t siz = 1;
+        while (siz < n) siz <<= 1;
+        n = siz;
+    }
+
+    m_len.resize(n);
+    m_offs.resize(n);
+    m_pos.assign(n, 0);
+    m_gain.assign(n, 0.);
+    m_damp.assign(n, 0.);
+
+    // Prime lengths on a geometric spread, all different
+    size_t total = 0, len = 0;
+    for (size_t j = 0; j < n; j++)
+    {
+        double t = n > 1 ? (double)j / (double)(n - 1) : 0.;
+        size_t target = (size_t)(fdn_min_del * std::pow(fdn_max_del / fdn_min_del, t) * m_sr);
+        len = std::max(target, len + 1);
+        while (!isPrime(len)) len++;
+        m_len[j] = len;
+        m_offs[j] = total;
+        total += len;
+    }
+    m_arena.assign(total, 0.);
+
+    // Spans are read before being written, so they cannot exceed the shortest line
+    m_span = std::min(m_s.size(), m_len[0]);
+    m_rows.assign((n + 1) * m_span, 0.);
+
+    m_curRT60 = m_curFreq = -1.;
+    update(0);
+}
+
+void FdnReverb::update(size_t indx)
+{
+    if (m_curRT60 != m_rt60[indx])
+    {
+        m_curRT60 = m_rt60[indx];
+        for (size_t j = 0; j < m_len.size(); j++)
+            m_gain[j] = Comb::fbFromRT60(m_len[j] / m_sr, m_curRT60);
+    }
+
+    if (m_curFreq != m_dampFreq[indx])
+    {
+        m_curFreq = m_dampFreq[indx];
+        ToneLP::coefs(m_curFreq, m_sr, m_a, m_b);
+    }
+}
+
+void FdnReverb::mix(size_t frames)
+{
+    size_t n = m_len.size();
+    double* rows = m_rows.data();
+
+    if (m_matrix == hadamardMatrix)
+    {
+        // Fast Walsh-Hadamard transform, each butterfly over whole rows
+        for (size_t h = 1; h < n; h <<= 1)
+            for (size_t j = 0; j < n; j += 2 * h)
+                for (size_t k = j; k < j + h; k++)
+                {
+                    double* r0 = rows + k * m_span;
+                    double* r1 = rows + (k + h) * m_span;
+                    for (size_t i = 0; i < frames; i++)
+                    {
+                        double a = r0[i], b = r1[i];
+                        r0[i] = a + b;
+                        r1[i] = a - b;
+                    }
+                }
+
+        double norm = 1. / std::sqrt((double)n);
+        for (size_t i = 0; i < n * m_span; i++)
+            rows[i] *= norm;
+    }
+    else
+    {
+        // Householder reflection, I - 2/N * ones
+        double* sum = rows + n * m_span;
+        std::fill(sum, sum + frames, 0.);
+        for (size_t j = 0; j < n; j++)
+        {
+            const double* r = rows + j * m_span;
+            for (size_t i = 0; i < frames; i++)
+                sum[i] += r[i];
+        }
+
+        double k = 2. / (double)n;
+        for (size_t j = 0; j < n; j++)
+        {
+            double* r = rows + j * m_span;
+            for (size_t i = 0; i < frames; i++)
+                r[i] -= k * sum[i];
+        }
+    }
+}
+
+void FdnReverb::dsp()
+{
+    size_t n = m_len.size();
+    double scal = 1. / std::sqrt((double)n);
+    const double* in = m_sigIn.data();
+
+    for (size_t start = 0; start < m_s.size(); start += m_span)
+    {
+        size_t frames = std::min(m_span, m_s.size() - start);
+        double* out = m_s.data() + start;
+        update(start);
+
+        // Read the line outputs, damp them and tap them with alternating signs
+        std::fill(out, out + frames, 0.);
+        for (size_t j = 0; j < n; j++)
+        {
+            double* row = m_rows.data() + j * m_span;
+            double* line = m_arena.data() + m_offs[j];
+            size_t first = std::min(frames, m_len[j] - m_pos[j]);
+            std::memcpy(row, line + m_pos[j], first * sizeof(double));
+            std::memcpy(row + first, line, (frames - first) * sizeof(double));
+
+            double g = m_gain[j], z = m_damp[j];
+            for (size_t i = 0; i < frames; i++)
+            {
+                z = m_a * row[i] - m_b * z;
+                row[i] = flushDenormal(g * z);
+            }
+            m_damp[j] = flushDenormal(z);
+
+            double sgn = j & 1 ? -scal : scal;
+            for (size_t i = 0; i < frames; i++)
+                out[i] += sgn * row[i];
+        }
+
+        mix(frames);
+
+        // Feed the mixed lines plus the input back into the lines
+        for (size_t j = 0; j < n; j++)
+        {
+            const double* row = m_rows.data() + j * m_span;
+            double* line = m_arena.data() + m_offs[j];
+            const double* x = in + start;
+            size_t first = std::min(frames, m_len[j] - m_pos[j]);
+            for (size_t i = 0; i < first; i++)
+                line[m_pos[j] + i] = row[i] + scal * x[i];
+            for (size_t i = first; i < frames; i++)
+                line[i - first] = row[i] + scal * x[i];
+            m_pos[j] = first < frames ? frames - first : m_pos[j] + frames;
+            if (m_pos[j] == m_len[j]) m_pos[j] = 0;
+        }
+    }
+}
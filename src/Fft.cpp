@@ -0,0 +1,182 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Fft class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Fft.h"
+#include <algorithm>
+
+using namespace KiwiWaves;
+
+Fft::Fft(size_t siz) : m_size(4)
+{
+    while (m_size < siz) m_size <<= 1;
+    m_half = m_size / 2;
+    m_re.resize(m_half);
+    m_im.resize(m_half);
+
+    size_t bits = 0;
+    while (((size_t)1 << bits) < m_half) bits++;
+    m_bitRev.resize(m_half);
+    for (size_t i = 0; i < m_half; i++)
+    {
+        size_t r = 0;
+        for (size_t b = 0; b < bits; b++)
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        m_bitRev[i] = r;
+    }
+
+    // Twiddle plan of the radix-4 stages, after a radix-2 one if bits is odd
+    m_radix2 = bits % 2 == 1;
+    for (size_t h = m_radix2 ? 2 : 1; h < m_half; h *= 4)
+    {
+        for (size_t p = 1; p <= 3; p++)
+            for (size_t j = 0; j < h; j++)
+            {
+                m_twRe.push_back(std::cos(twopi * p * j / (4 * h)));
+                m_twIm.push_back(std::sin(twopi * p * j / (4 * h)));
+            }
+    }
+
+    m_rcos.resize(m_half);
+    m_rsin.resize(m_half);
+    for (size_t k = 0; k < m_half; k++)
+    {
+        m_rcos[k] = std::cos(twopi * k / m_size);
+        m_rsin[k] = std::sin(twopi * k / m_size);
+    }
+}
+
+void Fft::complexFft(double sign)
+{
+    double* re = m_re.data();
+    double* im = m_im.data();
+
+    // Decimation in time on bit-reversed input: a radix-2 stage if needed,
+    // then radix-4 stages merging four transforms of size h into one of size 4h
+    size_t h = 1;
+    if (!m_radix2)
+    {
+        // First radix-4 stage, all its twiddles are one
+        for (size_t i = 0; i < m_half; i += 4)
+        {
+            double sr = re[i] + re[i + 1], si = im[i] + im[i + 1];
+            double tr = re[i] - re[i + 1], ti = im[i] - im[i + 1];
+            double ur = re[i + 2] + re[i + 3], ui = im[i + 2] + im[i + 3];
+            double vr = re[i + 2] - re[i + 3], vi = im[i + 2] - im[i + 3];
+            re[i] = sr + ur;
+            im[i] = si + ui;
+            re[i + 2] = sr - ur;
+            im[i + 2] = si - ui;
+            re[i + 1] = tr - sign * vi;
+            im[i + 1] = ti + sign * vr;
+            re[i + 3] = tr + sign * vi;
+            im[i + 3] = ti - sign * vr;
+        }
+        h = 4;
+    }
+    else
+    {
+        for (size_t i = 0; i < m_half; i += 2)
+        {
+            double ar = re[i], ai = im[i];
+            re[i] = ar + re[i + 1];
+            im[i] = ai + im[i + 1];
+            re[i + 1] = ar - re[i + 1];
+            im[i + 1] = ai - im[i + 1];
+        }
+        h = 2;
+    }
+
+    const double* twr = m_twRe.data() + (m_radix2 ? 0 : 3);
+    const double* twi = m_twIm.data() + (m_radix2 ? 0 : 3);
+    for (; h < m_half; h *= 4)
+    {
+        const double* w1r = twr, * w2r = twr + h, * w3r = twr + 2 * h;
+        const double* w1i = twi, * w2i = twi + h, * w3i = twi + 2 * h;
+        for (size_t start = 0; start < m_half; start += 4 * h)
+        {
+            for (size_t j = start; j < start + h; j++)
+            {
+                size_t k = j - start;
+                double s1 = sign * w1i[k], s2 = sign * w2i[k], s3 = sign * w3i[k];
+                double br = w2r[k] * re[j + h] - s2 * im[j + h], bi = w2r[k] * im[j + h] + s2 * re[j + h];
+                double cr = w1r[k] * re[j + 2 * h] - s1 * im[j + 2 * h], ci = w1r[k] * im[j + 2 * h] + s1 * re[j + 2 * h];
+                double dr = w3r[k] * re[j + 3 * h] - s3 * im[j + 3 * h], di = w3r[k] * im[j + 3 * h] + s3 * re[j + 3 * h];
+
+                double sr = re[j] + br, si = im[j] + bi;
+                double tr = re[j] - br, ti = im[j] - bi;
+                double ur = cr + dr, ui = ci + di;
+                double vr = cr - dr, vi = ci - di;
+
+                // sign * i * (C - D) completes the odd outputs
+                re[j] = sr + ur;
+                im[j] = si + ui;
+                re[j + 2 * h] = sr - ur;
+                im[j + 2 * h] = si - ui;
+                re[j + h] = tr - sign * vi;
+                im[j + h] = ti + sign * vr;
+                re[j + 3 * h] = tr + sign * vi;
+                im[j + 3 * h] = ti - sign * vr;
+            }
+        }
+        twr += 3 * h;
+        twi += 3 * h;
+    }
+}
+
+void Fft::forward(const double* in, double* re, double* im)
+{
+    // Even samples as real parts, odd samples as imaginary parts
+    for (size_t n = 0; n < m_half; n++)
+    {
+        m_re[m_bitRev[n]] = in[2 * n];
+        m_im[m_bitRev[n]] = in[2 * n + 1];
+    }
+    complexFft(-1.);
+
+    re[0] = m_re[0] + m_im[0];
+    im[0] = 0.;
+    re[m_half] = m_re[0] - m_im[0];
+    im[m_half] = 0.;
+
+    // Split the half-size spectrum into the spectra of the even
+    // and odd samples, and combine them with the real twiddles
+    for (size_t k = 1; k < m_half; k++)
+    {
+        double ar = m_re[k], ai = m_im[k];
+        double br = m_re[m_half - k], bi = -m_im[m_half - k];
+        double er = 0.5 * (ar + br), ei = 0.5 * (ai + bi);
+        double orr = 0.5 * (ai - bi), oi = -0.5 * (ar - br);
+        double c = m_rcos[k], s = m_rsin[k];
+        re[k] = er + c * orr + s * oi;
+        im[k] = ei + c * oi - s * orr;
+    }
+}
+
+void Fft::inverse(const double* re, const double* im, double* out)
+{
+    for (size_t k = 0; k < m_half; k++)
+    {
+        double er = 0.5 * (re[k] + re[m_half - k]), ei = 0.5 * (im[k] - im[m_half - k]);
+        double dr = 0.5 * (re[k] - re[m_half - k]), di = 0.5 * (im[k] + im[m_half - k]);
+        double c = m_rcos[k], s = m_rsin[k];
+        double orr = dr * c - di * s, oi = dr * s + di * c;
+        m_re[m_bitRev[k]] = er - oi;
+        m_im[m_bitRev[k]] = ei + orr;
+    }
+    complexFft(1.);
+
+    double scal = 1. / m_half;
+    for (size_t n = 0; n < m_half; n++)
+    {
+        out[2 * n] = m_re[n] * scal;
+        out[2 * n + 1] = m_im[n] * scal;
+    }
+}
@@ -10,10 +10,37 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include <cmath>
+#include <thread>
+#include <vector>
+#include <algorithm>
 #include "Iir.h"
+#include "Denormals.h"
 
 using namespace KiwiWaves;
 
+namespace
+{
+    /** Smallest chunk worth giving to a thread in Iir::processOffline.
+    */
+    const size_t min_offline_chunk = 16384;
+
+    /** Run job(0) ... job(count - 1), each one on its own thread,
+        with the flush-to-zero mode of the calling thread.
+    */
+    template <typename Job>
+    void runParallel(size_t count, const Job& job)
+    {
+        std::vector<std::thread> workers;
+        bool ftz = DenormalScope::active();
+        for (size_t k = 1; k < count; k++)
+            workers.emplace_back([&job, ftz](size_t i) { DenormalScope scope(ftz); job(i); }, k);
+
+        if (count > 0) job(0);
+        for (size_t k = 0; k < workers.size(); k++)
+            workers[k].join();
+    }
+}
+
 void Iir::dsp() {
     double w;
     m_sigIn.process();
@@ -28,4 +55,103 @@ void Iir::dsp() {
         m_del[1] = m_del[0];
         m_del[0] = w;
     }
+    flushDenormals(m_del, 2);
+}
+
+void Iir::filterSpan(const double* in, double* out, size_t frames, double* del) const
+{
+    double w;
+    if (out == nullptr)
+    {
+        for (size_t i = 0; i < frames; i++)
+        {
+            w = m_scal * in[i] - m_b[0] * del[0] - m_b[1] * del[1];
+            del[1] = del[0];
+            del[0] = w;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < frames; i++)
+    {
+        w = m_scal * in[i] - m_b[0] * del[0] - m_b[1] * del[1];
+        out[i] = w * m_a[0] + m_a[1] * del[0] + m_a[2] * del[1];
+        del[1] = del[0];
+        del[0] = w;
+    }
+}
+
+void Iir::statePower(size_t frames, double* mat) const
+{
+    // The state (w[n-1], w[n-2]) evolves with no input through
+    // the companion matrix | -b1 -b2 |, raised here to the frames power.
+    //                      |  1   0  |
+    double base[4] = { -m_b[0], -m_b[1], 1., 0. };
+    double tmp[4];
+    mat[0] = 1.; mat[1] = 0.; mat[2] = 0.; mat[3] = 1.;
+
+    while (frames > 0)
+    {
+        if (frames & 1)
+        {
+            tmp[0] = mat[0] * base[0] + mat[1] * base[2];
+            tmp[1] = mat[0] * base[1] + mat[1] * base[3];
+            tmp[2] = mat[2] * base[0] + mat[3] * base[2];
+            tmp[3] = mat[2] * base[1] + mat[3] * base[3];
+            std::copy(tmp, tmp + 4, mat);
+        }
+        tmp[0] = base[0] * base[0] + base[1] * base[2];
+        tmp[1] = base[0] * base[1] + base[1] * base[3];
+        tmp[2] = base[2] * base[0] + base[3] * base[2];
+        tmp[3] = base[2] * base[1] + base[3] * base[3];
+        std::copy(tmp, tmp + 4, base);
+        frames >>= 1;
+    }
+}
+
+void Iir::processOffline(const double* in, double* out, size_t frames, unsigned int threads)
+{
+    if (prepareUpdate(0)) update();
+
+    if (threads == 0) threads = std::max(std::thread::hardware_concurrency(), 1u);
+    size_t chunks = std::min((size_t)threads, frames / min_offline_chunk);
+    if (chunks <= 1)
+    {
+        filterSpan(in, out, frames, m_del);
+        flushDenormals(m_del, 2);
+        return;
+    }
+
+    // Every chunk is len frames long except the last one, which takes the remainder.
+    size_t len = frames / chunks;
+    std::vector<double> zeroState(2 * chunks, 0.);
+    std::vector<double> start(2 * chunks, 0.);
+
+    // 1. Final state of each chunk when filtered from a zero state.
+    runParallel(chunks - 1, [&](size_t k) {
+        filterSpan(in + k * len, nullptr, len, &zeroState[2 * k]);
+    });
+
+    // 2. Actual start state of each chunk: the previous start state
+    // carried over the previous chunk, plus its zero-state contribution.
+    double mat[4];
+    statePower(len, mat);
+    start[0] = m_del[0];
+    start[1] = m_del[1];
+    for (size_t k = 1; k < chunks; k++)
+    {
+        const double* prev = &start[2 * (k - 1)];
+        start[2 * k] = mat[0] * prev[0] + mat[1] * prev[1] + zeroState[2 * (k - 1)];
+        start[2 * k + 1] = mat[2] * prev[0] + mat[3] * prev[1] + zeroState[2 * (k - 1) + 1];
+    }
+
+    // 3. Filter every chunk from its start state.
+    runParallel(chunks, [&](size_t k) {
+        size_t n = k < chunks - 1 ? len : frames - k * len;
+        filterSpan(in + k * len, out + k * len, n, &start[2 * k]);
+    });
+
+    m_del[0] = start[2 * (chunks - 1)];
+    m_del[1] = start[2 * (chunks - 1) + 1];
+    flushDenormals(m_del, 2);
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the IirMulti, LowPMulti and HighPMulti classes
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "IirMulti.h"
+#include "Butterworth.h"
+#include "Denormals.h"
+
+using namespace KiwiWaves;
+
+void IirMulti::setCoefs(const double* a, const double* b)
+{
+    for (size_t c = 0; c < nchnls(); c++)
+        setCoefs(c, a, b);
+}
+
+void IirMulti::setCoefs(size_t chn, const double* a, const double* b)
+{
+    size_t n = nchnls();
+    m_a[chn] = a[0];
+    m_a[n + chn] = a[1];
+    m_a[2 * n + chn] = a[2];
+    m_b[chn] = b[0];
+    m_b[n + chn] = b[1];
+}
+
+void IirMulti::dsp()
+{
+    size_t n = nchnls();
+    for (size_t c = 0; c < n; c++)
+    {
+        m_sigIns[c]->process();
+        m_inData[c] = m_sigIns[c]->data();
+    }
+
+    const double* a0 = m_a.data();
+    const double* a1 = a0 + n;
+    const double* a2 = a1 + n;
+    const double* b1 = m_b.data();
+    const double* b2 = b1 + n;
+    double* d1 = m_del.data();
+    double* d2 = d1 + n;
+    double* x = m_x.data();
+    double* y = m_y.data();
+    double w;
+
+    for (size_t i = 0; i < m_frames; i++)
+    {
+        if (prepareUpdate(i)) update();
+
+        for (size_t c = 0; c < n; c++)
+            x[c] = m_inData[c][i];
+
+        // Direct Form II implementation, one lane per channel
+        for (size_t c = 0; c < n; c++)
+        {
+            w = x[c] - b1[c] * d1[c] - b2[c] * d2[c];
+            y[c] = w * a0[c] + a1[c] * d1[c] + a2[c] * d2[c];
+            d2[c] = d1[c];
+            d1[c] = w;
+        }
+
+        for (size_t c = 0; c < n; c++)
+            m_s[c * m_frames + i] = y[c];
+    }
+    flushDenormals(m_del.data(), m_del.size());
+}
+
+bool LowPMulti::prepareUpdate(const size_t& indx)
+{
+    if (m_freq != m_cutFreq[indx])
+    {
+        m_freq = m_cutFreq[indx];
+        return true;
+    }
+    return false;
+}
+
+void LowPMulti::update()
+{
+    double a[3], b[2];
+    LowP::coefs(m_freq, m_sr, a, b);
+    setCoefs(a, b);
+}
+
+void LowPMulti::setCutFreq(size_t chn, double val)
+{
+    double a[3], b[2];
+    LowP::coefs(val, m_sr, a, b);
+    setCoefs(chn, a, b);
+}
+
+void HighPMulti::update()
+{
+    double a[3], b[2];
+    HighP::coefs(m_freq, m_sr, a, b);
+    setCoefs(a, b);
+}
+
+void HighPMulti::setCutFreq(size_t chn, double val)
+{
+    double a[3], b[2];
+    HighP::coefs(val, m_sr, a, b);
+    setCoefs(chn, a, b);
+}
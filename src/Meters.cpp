@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the RmsMeter and PeakMeter classes
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Meters.h"
+#include <algorithm>
+
+using namespace KiwiWaves;
+
+void RmsMeter::reset()
+{
+    std::fill(m_squares.begin(), m_squares.end(), 0.);
+    m_pos = 0;
+    m_sum = m_fresh = m_value = 0.;
+}
+
+void RmsMeter::dsp()
+{
+    const double* in = m_sigIn.data();
+    double* sq = m_squares.data();
+    size_t n = inputFrames(), j = 0;
+
+    for (size_t i = 0; i < n; j++)
+    {
+        size_t end = std::min(i + m_decim, n);
+        while (i < end)
+        {
+            // Up to the end of the group or the wrap of the window
+            size_t len = std::min(end - i, m_win - m_pos);
+            double sum = m_sum, fresh = m_fresh;
+            for (size_t k = 0; k < len; k++)
+            {
+                double x = in[i + k] * in[i + k];
+                sum += x - sq[m_pos + k];
+                fresh += x;
+                sq[m_pos + k] = x;
+            }
+            m_sum = sum;
+            m_fresh = fresh;
+            i += len;
+            m_pos += len;
+
+            // The fresh sum now holds exactly the samples in the window
+            if (m_pos == m_win)
+            {
+                m_pos = 0;
+                m_sum = m_fresh;
+                m_fresh = 0.;
+            }
+        }
+        m_s[j] = std::sqrt((m_sum > 0. ? m_sum : 0.) / m_win);
+    }
+    holdLast(j);
+}
+
+void PeakMeter::reset()
+{
+    m_count = m_head = m_size = 0;
+    m_value = 0.;
+}
+
+void PeakMeter::dsp()
+{
+    const double* in = m_sigIn.data();
+    size_t n = inputFrames(), j = 0;
+
+    for (size_t i = 0; i < n; j++)
+    {
+        size_t end = std::min(i + m_decim, n);
+        for (; i < end; i++, m_count++)
+        {
+            double x = std::fabs(in[i]);
+
+            // Drop the oldest candidate once it leaves the window,
+            // and the ones that can no longer be the maximum
+            if (m_size > 0 && m_times[m_head] + m_win <= m_count)
+            {
+                m_head = m_head + 1 < m_win ? m_head + 1 : 0;
+                m_size--;
+            }
+            while (m_size > 0)
+            {
+                size_t back = m_head + m_size - 1;
+                back -= back >= m_win ? m_win : 0;
+                if (m_vals[back] > x) break;
+                m_size--;
+            }
+
+            size_t tail = m_head + m_size;
+            tail -= tail >= m_win ? m_win : 0;
+            m_vals[tail] = x;
+            m_times[tail] = m_count;
+            m_size++;
+        }
+        m_s[j] = m_vals[m_head];
+    }
+    holdLast(j);
+}
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the DelayWrite and DelayTap classes
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "MultiTap.h"
+#include "Denormals.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+void DelayWrite::dsp()
+{
+    size_t vsiz = m_s.size();
+    size_t first = std::min(vsiz, m_delLine.size() - m_writePos);
+    const double* in = m_sigIn.data();
+
+    std::memcpy(m_delLine.data() + m_writePos, in, first * sizeof(double));
+    std::memcpy(m_delLine.data(), in + first, (vsiz - first) * sizeof(double));
+    std::memcpy(m_s.data(), in, vsiz * sizeof(double));
+
+    m_blockStart = m_writePos;
+    m_writePos = (m_writePos + vsiz) & m_mask;
+}
+
+void DelayTap::dsp()
+{
+    double* line = m_writer.m_delLine.data();
+    size_t mask = m_writer.m_mask;
+    size_t start = m_writer.m_blockStart;
+    double maxDel = m_writer.m_maxDel;
+    double delSample, a;
+    size_t readOffs, readPosI;
+
+    // Fixed integer delay without feedback: a plain span copy
+    if (!m_delVal.modulated() && !m_fb.modulated() && m_fb[0] == 0.)
+    {
+        delSample = m_delVal[0] < 0. ? 0. : (m_delVal[0] * m_sr > maxDel ? maxDel : m_delVal[0] * m_sr);
+        readOffs = (size_t)std::ceil(delSample);
+        if (!m_interp || (double)readOffs == delSample)
+        {
+            size_t readPos = (start - readOffs) & mask;
+            size_t first = std::min(m_s.size(), m_writer.m_delLine.size() - readPos);
+            std::memcpy(m_s.data(), line + readPos, first * sizeof(double));
+            std::memcpy(m_s.data() + first, line, (m_s.size() - first) * sizeof(double));
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < m_s.size(); i++)
+    {
+        delSample = (m_delVal[i] < 0. ? 0. : m_delVal[i] * m_sr);
+        if (delSample > maxDel)
+            delSample = maxDel;
+
+        readOffs = (size_t)std::ceil(delSample);
+        readPosI = (start + i - readOffs) & mask;
+
+        if (m_interp)
+        {
+            a = line[readPosI];
+            m_s[i] = a + ((double)readOffs - delSample) * (line[(readPosI + 1) & mask] - a); // linear interpolation
+        }
+        else
+        {
+            m_s[i] = line[readPosI]; // no interp
+        }
+
+        line[(start + i) & mask] += flushDenormal(m_s[i] * m_fb[i]);
+    }
+}
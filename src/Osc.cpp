@@ -18,10 +18,21 @@ void Osc::dsp()
 	// An oscillator is reading a table with the index dictated by a phasor,
 	// multiplied by an amplitude and adding the DC offset.
 
-	m_ph.process();
-	m_tr.process();
+	processMember(m_ph);
+	processMember(*m_tr);
 
-	for (size_t i = 0; i < m_s.size(); i++) {
-		m_s[i] = m_tr[i] * m_amp[i] + m_dcoff;
+	size_t n = m_s.size();
+	UGenParam::Block amp = m_amp.block();
+	const double* tab = m_tr->data();
+	double* out = m_s.data();
+
+	if (amp.stride == 0) {
+		double a = amp[0];
+		for (size_t i = 0; i < n; i++)
+			out[i] = tab[i] * a + m_dcoff;
+	}
+	else {
+		for (size_t i = 0; i < n; i++)
+			out[i] = tab[i] * amp.ptr[i] + m_dcoff;
 	}
 }
\ No newline at end of file
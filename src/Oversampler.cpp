@@ -0,0 +1,144 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the HalfBand and Oversampler classes
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Oversampler.h"
+#include "Kaiser.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+HalfBand::HalfBand(size_t taps, size_t block) : m_block(block)
+{
+    // Ideal half-band response h(d) = sin(pi d / 2) / (pi d) at the odd
+    // offsets d from the center, Kaiser window reaching zero at 2 * taps
+    const double beta = 8.;
+    double sum = 0.;
+    m_coefs.resize(taps);
+    for (size_t j = 0; j < taps; j++)
+    {
+        double d = 2. * j + 1., w = kaiser(d / (2. * taps), beta);
+        m_coefs[j] = (j % 2 ? -1. : 1.) / (pi * d) * w;
+        sum += m_coefs[j];
+    }
+
+    // Unity gain at DC, the center tap is 0.5
+    for (double& c : m_coefs)
+        c *= 0.25 / sum;
+
+    m_upBuf.assign(2 * taps - 1 + block, 0.);
+    m_downBuf.assign(4 * taps - 2 + 2 * block, 0.);
+}
+
+void HalfBand::reset()
+{
+    std::fill(m_upBuf.begin(), m_upBuf.end(), 0.);
+    std::fill(m_downBuf.begin(), m_downBuf.end(), 0.);
+}
+
+void HalfBand::up(const double* in, double* out)
+{
+    size_t taps = m_coefs.size(), hist = 2 * taps - 1;
+    const double* c = m_coefs.data();
+    double* x = m_upBuf.data();
+    std::memcpy(x + hist, in, m_block * sizeof(double));
+
+    // Window of the last 2 * taps inputs, the center tap on the odd outputs
+    for (size_t m = 0; m < m_block; m++)
+    {
+        const double* xw = x + m;
+        double acc = 0.;
+        for (size_t j = 0; j < taps; j++)
+            acc += c[j] * (xw[taps + j] + xw[taps - 1 - j]);
+        out[2 * m] = 2. * acc;
+        out[2 * m + 1] = xw[taps];
+    }
+
+    std::memmove(x, x + m_block, hist * sizeof(double));
+}
+
+void HalfBand::down(const double* in, double* out)
+{
+    size_t taps = m_coefs.size(), hist = 4 * taps - 2;
+    const double* c = m_coefs.data();
+    double* v = m_downBuf.data();
+    std::memcpy(v + hist, in, 2 * m_block * sizeof(double));
+
+    // Window of the last 4 * taps - 1 inputs, the center tap falls on
+    // an odd sample and the others on even ones
+    for (size_t m = 0; m < m_block; m++)
+    {
+        const double* vw = v + 2 * m;
+        double acc = 0.;
+        for (size_t j = 0; j < taps; j++)
+            acc += c[j] * (vw[2 * taps + 2 * j] + vw[2 * taps - 2 - 2 * j]);
+        out[m] = acc + 0.5 * vw[2 * taps - 1];
+    }
+
+    std::memmove(v, v + 2 * m_block, hist * sizeof(double));
+}
+
+Oversampler::Oversampler(UGen& signalIn, size_t factor, size_t vsiz, double sr) :
+    m_sigIn(signalIn), m_inner(vsiz * (factor > 4 ? 8 : (factor > 2 ? 4 : 2)), sr * (factor > 4 ? 8 : (factor > 2 ? 4 : 2))),
+    UGen(vsiz, sr)
+{
+    // Taps per stage, the later stages have wider transition bands
+    const size_t taps[3] = { 24, 8, 6 };
+    size_t block = vsiz;
+    for (size_t s = 0; block < m_inner.vsize(); s++, block *= 2)
+        m_stages.emplace_back(taps[s], block);
+
+    m_bufA.assign(m_inner.vsize(), 0.);
+    m_bufB.assign(m_inner.vsize(), 0.);
+}
+
+double Oversampler::latency() const
+{
+    // Both directions of each stage, at twice the rate of the stage input
+    double lat = 0., scale = 2.;
+    for (const HalfBand& hb : m_stages)
+    {
+        lat += 2. * hb.latency() / scale;
+        scale *= 2.;
+    }
+    return lat;
+}
+
+void Oversampler::reset()
+{
+    for (HalfBand& hb : m_stages)
+        hb.reset();
+}
+
+void Oversampler::dsp()
+{
+    // Up through the stages, the last one writes the subgraph input
+    const double* src = m_sigIn.data();
+    double* bufs[2] = { m_bufA.data(), m_bufB.data() };
+    for (size_t s = 0; s < m_stages.size(); s++)
+    {
+        m_stages[s].up(src, bufs[s % 2]);
+        src = bufs[s % 2];
+    }
+    m_inner.setData(src, m_inner.vsize());
+
+    for (UGen* child : m_children)
+        child->process();
+
+    // And down from the output of the subgraph
+    src = m_children.empty() ? m_inner.data() : m_children.back()->data();
+    for (size_t s = m_stages.size(); s-- > 1;)
+    {
+        m_stages[s].down(src, bufs[s % 2]);
+        src = bufs[s % 2];
+    }
+    m_stages[0].down(src, m_s.data());
+}
@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the PhaseVocoder class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "PhaseVocoder.h"
+#include "FastMath.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+void PhaseVocoder::init(size_t hop)
+{
+    size_t n = m_fft.size(), bins = n / 2 + 1;
+    m_hop = hop > 0 && hop < n / 4 ? hop : n / 4;
+
+    double sum = 0.;
+    m_win.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        m_win[i] = 0.5 - 0.5 * std::cos(twopi * i / n);
+        sum += m_win[i] * m_win[i];
+    }
+    m_norm = (double)m_hop / sum;
+
+    m_time.assign(n, 0.);
+    m_acc.assign(n, 0.);
+    m_outBuf.assign(m_hop, 0.);
+    m_re.assign(bins, 0.);
+    m_im.assign(bins, 0.);
+    m_mag.assign(bins, 0.);
+    m_phase.assign(bins, 0.);
+    m_prevPhase.assign(bins, 0.);
+    m_freq.assign(bins, 0.);
+    m_outMag.assign(bins, 0.);
+    m_outPh.assign(bins, 0.);
+    m_synPh.assign(bins, 0.);
+    m_peaks.assign(bins, 0);
+
+    m_pos = 0.;
+    m_prevStart = 0;
+    m_fill = m_hop;
+    m_first = true;
+}
+
+void PhaseVocoder::frame(size_t indx)
+{
+    size_t n = m_fft.size(), bins = n / 2 + 1;
+    double pitch = m_pitch[indx], stretch = m_stretch[indx];
+
+    // Analysis, the table reads as zeros past its end
+    size_t start = (size_t)m_pos;
+    for (size_t i = 0; i < n; i++)
+        m_time[i] = start + i < m_src.size() ? m_src[start + i] * m_win[i] : 0.;
+    m_fft.forward(m_time.data(), m_re.data(), m_im.data());
+
+    for (size_t k = 0; k < bins; k++)
+        m_mag[k] = std::sqrt(m_re[k] * m_re[k] + m_im[k] * m_im[k]);
+    FastMath::atan2(m_im.data(), m_re.data(), m_phase.data(), bins);
+
+    size_t npeaks = 0;
+    for (size_t k = 1; k + 1 < bins; k++)
+        if (m_mag[k] > m_mag[k - 1] && m_mag[k] >= m_mag[k + 1])
+            m_peaks[npeaks++] = k;
+
+    // Peaks advance with their instantaneous frequency, and the bins
+    // in their region of influence keep their phase offset to them
+    size_t aHop = start - m_prevStart;
+    std::fill(m_outMag.begin(), m_outMag.end(), 0.);
+    std::memcpy(m_outPh.data(), m_synPh.data(), bins * sizeof(double));
+    for (size_t q = 0; q < npeaks; q++)
+    {
+        size_t k = m_peaks[q];
+        size_t lo = q == 0 ? 0 : (m_peaks[q - 1] + k) / 2 + 1;
+        size_t hi = q + 1 == npeaks ? bins - 1 : (k + m_peaks[q + 1]) / 2;
+
+        double omega = twopi * k / n;
+        if (!m_first && aHop > 0)
+        {
+            double d = m_phase[k] - m_prevPhase[k] - omega * aHop;
+            d -= twopi * FastMath::round(d / twopi);
+            m_freq[k] = omega + d / aHop;
+        }
+        else if (m_first)
+            m_freq[k] = omega;
+
+        long shift = (long)FastMath::round(k * pitch) - (long)k;
+        long k2 = (long)k + shift;
+        if (k2 <= 0 || k2 >= (long)bins) continue;
+
+        double ph = m_first ? m_phase[k] : m_synPh[k2] + pitch * m_freq[k] * m_hop;
+        for (size_t j = lo; j <= hi; j++)
+        {
+            long j2 = (long)j + shift;
+            if (j2 < 0 || j2 >= (long)bins) continue;
+            m_outMag[j2] += m_mag[j];
+            m_outPh[j2] = ph + m_phase[j] - m_phase[k];
+        }
+    }
+
+    // Resynthesis
+    FastMath::cos(m_outPh.data(), m_re.data(), bins);
+    FastMath::sin(m_outPh.data(), m_im.data(), bins);
+    for (size_t k = 0; k < bins; k++)
+    {
+        m_re[k] *= m_outMag[k];
+        m_im[k] *= m_outMag[k];
+        m_synPh[k] = m_outPh[k] - twopi * FastMath::round(m_outPh[k] / twopi);
+    }
+    m_fft.inverse(m_re.data(), m_im.data(), m_time.data());
+    for (size_t i = 0; i < n; i++)
+        m_acc[i] += m_time[i] * m_win[i] * m_norm;
+
+    std::memcpy(m_outBuf.data(), m_acc.data(), m_hop * sizeof(double));
+    std::memmove(m_acc.data(), m_acc.data() + m_hop, (n - m_hop) * sizeof(double));
+    std::fill(m_acc.end() - m_hop, m_acc.end(), 0.);
+
+    std::swap(m_prevPhase, m_phase);
+    m_prevStart = start;
+    m_first = false;
+    if (stretch > 0.) m_pos += m_hop / stretch;
+}
+
+void PhaseVocoder::dsp()
+{
+    for (size_t pos = 0; pos < m_s.size();)
+    {
+        if (m_fill == m_hop)
+        {
+            frame(pos);
+            m_fill = 0;
+        }
+
+        size_t len = std::min(m_hop - m_fill, m_s.size() - pos);
+        std::memcpy(m_s.data() + pos, m_outBuf.data() + m_fill, len * sizeof(double));
+        m_fill += len;
+        pos += len;
+    }
+}
@@ -16,10 +16,38 @@ using namespace KiwiWaves;
 
 void Phasor::dsp()
 {
-	for (size_t i = 0; i < m_s.size(); i++)
+	size_t n = m_s.size();
+	UGenParam::Block fr = m_fr.block();
+	double* out = m_s.data();
+	double ph = m_ph;
+
+	for (size_t i = 0; i < n;)
 	{
-		m_s[i] = m_ph;
-		m_ph += m_fr[i] / m_sr;
-		m_ph = m_ph - floor(m_ph); // mod1
+		for (; m_events.next(n) == i; m_events.pop())
+			ph = m_events.front().value - floor(m_events.front().value);
+
+		// The increment of a fixed frequency is computed once per run
+		size_t end = m_events.next(n);
+		if (fr.stride == 0)
+		{
+			double inc = fr[0] / m_sr;
+			for (; i < end; i++)
+			{
+				out[i] = ph;
+				ph += inc;
+				ph = ph - floor(ph); // mod1
+			}
+		}
+		else
+		{
+			for (; i < end; i++)
+			{
+				out[i] = ph;
+				ph += fr.ptr[i] / m_sr;
+				ph = ph - floor(ph); // mod1
+			}
+		}
 	}
+	m_ph = ph;
+	m_events.advance(n);
 }
\ No newline at end of file
@@ -0,0 +1,151 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Profile reports
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Profile.h"
+#include "UGen.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <typeinfo>
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+
+using namespace KiwiWaves;
+
+double Profile::ticksPerSecond()
+{
+#ifdef KIWIWAVES_PROFILE_TSC
+    // Count the TSC over 50 ms of the steady clock, once
+    static const double rate = []()
+    {
+        std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now(), t1;
+        uint64_t c0 = ticks();
+        do t1 = std::chrono::steady_clock::now();
+        while (t1 - t0 < std::chrono::milliseconds(50));
+        uint64_t c1 = ticks();
+        return (c1 - c0) / std::chrono::duration<double>(t1 - t0).count();
+    }();
+    return rate;
+#else
+    return 1e9;
+#endif
+}
+
+std::string Profile::typeName(const std::type_info& type)
+{
+    const char* name = type.name();
+#ifdef __GNUG__
+    int status = 0;
+    char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+    if (status == 0)
+    {
+        std::string s(demangled);
+        std::free(demangled);
+        return s.compare(0, 11, "KiwiWaves::") == 0 ? s.substr(11) : s;
+    }
+#endif
+    return name;
+}
+
+#ifdef KIWIWAVES_PROFILE
+
+static bool moreTicks(const Profile::Entry& a, const Profile::Entry& b)
+{
+    return a.counters.ticks > b.counters.ticks;
+}
+
+Profile::Report Profile::report(const std::vector<const UGen*>& graph)
+{
+    Report rep;
+    rep.ticks = 0;
+    rep.seconds = 0.;
+    std::map<std::string, Entry> types;
+
+    for (const UGen* u : graph)
+    {
+        Entry e;
+        e.name = typeName(typeid(*u));
+        e.instances = 1;
+        e.counters = u->profile();
+        // Seconds of audio, the load of the entry is set below
+        e.load = e.counters.samples / u->sr();
+        rep.ticks += e.counters.ticks;
+        rep.seconds = std::max(rep.seconds, e.load);
+        rep.ugens.push_back(e);
+
+        std::map<std::string, Entry>::iterator t = types.find(e.name);
+        if (t == types.end())
+            types.insert(std::make_pair(e.name, e));
+        else
+        {
+            Counters& c = t->second.counters;
+            t->second.instances++;
+            c.calls += e.counters.calls;
+            c.samples += e.counters.samples;
+            c.ticks += e.counters.ticks;
+            c.maxTicks = std::max(c.maxTicks, e.counters.maxTicks);
+        }
+    }
+    for (std::pair<const std::string, Entry>& t : types)
+        rep.types.push_back(t.second);
+
+    // The graph has processed as much audio as its longest running UGen
+    double tps = ticksPerSecond();
+    rep.load = rep.seconds > 0. ? rep.ticks / tps / rep.seconds : 0.;
+    for (std::vector<Entry>* entries : { &rep.ugens, &rep.types })
+        for (Entry& e : *entries)
+        {
+            e.share = rep.ticks > 0 ? (double)e.counters.ticks / rep.ticks : 0.;
+            e.load = rep.seconds > 0. ? e.counters.ticks / tps / rep.seconds : 0.;
+        }
+
+    std::stable_sort(rep.ugens.begin(), rep.ugens.end(), moreTicks);
+    std::stable_sort(rep.types.begin(), rep.types.end(), moreTicks);
+    return rep;
+}
+
+static void printEntries(const char* title, const std::vector<Profile::Entry>& entries, std::ostream& os)
+{
+    char line[256];
+    std::snprintf(line, sizeof(line), "%-24s %6s %10s %12s %10s %10s %7s %7s\n", title, "count",
+        "calls", "samples", "ticks/call", "max", "share%", "load%");
+    os << line;
+    for (const Profile::Entry& e : entries)
+    {
+        const Profile::Counters& c = e.counters;
+        std::snprintf(line, sizeof(line), "%-24s %6zu %10llu %12llu %10.0f %10llu %7.2f %7.2f\n",
+            e.name.c_str(), e.instances, (unsigned long long)c.calls, (unsigned long long)c.samples,
+            c.calls ? (double)c.ticks / c.calls : 0., (unsigned long long)c.maxTicks,
+            100. * e.share, 100. * e.load);
+        os << line;
+    }
+}
+
+void Profile::print(const Report& rep, std::ostream& os)
+{
+    char line[128];
+    std::snprintf(line, sizeof(line), "%.3f s of audio, %.2f%% load at %.0f ticks/s\n",
+        rep.seconds, 100. * rep.load, ticksPerSecond());
+    os << line;
+    printEntries("ugen", rep.ugens, os);
+    os << "\n";
+    printEntries("type", rep.types, os);
+}
+
+void Profile::reset(const std::vector<UGen*>& graph)
+{
+    for (UGen* u : graph)
+        u->resetProfile();
+}
+
+#endif
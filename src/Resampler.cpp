@@ -0,0 +1,101 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Resampler class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Resampler.h"
+#include "Kaiser.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+void Resampler::init()
+{
+    const size_t zeros = def_resamp_zeros, phases = def_resamp_phases, taps = 2 * zeros;
+    const double beta = 9.;
+    m_ratio = m_sigIn.sr() / m_sr;
+
+    // Cutoff below the lower Nyquist frequency, leaving room for the transition band
+    double cut = 0.92 * (m_ratio > 1. ? 1. / m_ratio : 1.);
+
+    // Row p holds the taps for the input samples around a position p / phases
+    // past an input sample, an extra row closes the interpolation of the last phase
+    m_table.resize((phases + 1) * taps);
+    for (size_t p = 0; p <= phases; p++)
+    {
+        for (size_t k = 0; k < taps; k++)
+        {
+            double d = (double)k - (double)(zeros - 1) - (double)p / phases;
+            double x = pi * cut * d, w = kaiser(d / zeros, beta);
+            m_table[p * taps + k] = cut * (x != 0. ? std::sin(x) / x : 1.) * w;
+        }
+    }
+    m_diff.resize(phases * taps);
+    for (size_t i = 0; i < m_diff.size(); i++)
+        m_diff[i] = m_table[i + taps] - m_table[i];
+
+    m_fifo.assign(2 * taps + 2 * m_sigIn.vsize(), 0.);
+    reset();
+}
+
+void Resampler::reset()
+{
+    // History of zeros before the first input sample
+    std::fill(m_fifo.begin(), m_fifo.end(), 0.);
+    m_fill = def_resamp_zeros - 1;
+    m_pos = (double)m_fill;
+}
+
+void Resampler::pull()
+{
+    size_t vsiz = m_sigIn.vsize();
+    if (m_fill + vsiz > m_fifo.size())
+    {
+        // Drop the samples behind the filter, all of them if it has skipped past
+        size_t drop = std::min((size_t)m_pos - (def_resamp_zeros - 1), m_fill);
+        std::memmove(m_fifo.data(), m_fifo.data() + drop, (m_fill - drop) * sizeof(double));
+        m_fill -= drop;
+        m_pos -= (double)drop;
+    }
+    std::memcpy(m_fifo.data() + m_fill, m_sigIn.process(), vsiz * sizeof(double));
+    m_fill += vsiz;
+}
+
+void Resampler::dsp()
+{
+    const size_t zeros = def_resamp_zeros, phases = def_resamp_phases, taps = 2 * zeros;
+
+    for (size_t i = 0; i < m_s.size(); i++)
+    {
+        size_t ip = (size_t)m_pos;
+        while (m_fill < ip + zeros + 1)
+        {
+            pull();
+            ip = (size_t)m_pos;
+        }
+
+        double ph = (m_pos - ip) * phases;
+        size_t p = (size_t)ph;
+        double f = ph - p;
+        const double* x = m_fifo.data() + ip + 1 - zeros;
+        const double* a = m_table.data() + p * taps;
+        const double* d = m_diff.data() + p * taps;
+
+        // Four partial sums, so the dot product maps to vector registers
+        double acc[4] = { 0., 0., 0., 0. };
+        for (size_t k = 0; k < taps; k += 4)
+            for (size_t j = 0; j < 4; j++)
+                acc[j] += (a[k + j] + f * d[k + j]) * x[k + j];
+        m_s[i] = (acc[0] + acc[2]) + (acc[1] + acc[3]);
+
+        double speed = m_speed[i];
+        m_pos += m_ratio * (speed > 0. ? speed : 0.);
+    }
+}
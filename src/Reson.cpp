@@ -10,22 +10,31 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "Reson.h"
+#include "FastMath.h"
+#include "Denormals.h"
 
 using namespace KiwiWaves;
 
 void ResonR::update()
+{
+    if (m_coefTab) m_coefTab->lookup(m_freq, m_bw, m_a, m_b, m_scal);
+    else coefs(m_freq, m_bw, m_sr, m_a, m_b, m_scal, getMathPrecision());
+}
+
+void ResonR::coefs(double freq, double band, double sr, double* a, double* b, double& scal, MathPrecision prec)
 {
     double r, rsq, rr, costh;
-    r = exp(-m_bw * pi / m_sr);
+    r = exp(-band * pi / sr);
     rr = 2. * r;
     rsq = r * r;
-    costh = (rr / (1. + rsq)) * cos(2 * pi * m_freq / m_sr);
-    m_scal = (1 - rsq) * sin(acos(costh));
-    m_b[0] = -rr * costh;
-    m_b[1] = rsq;
-    m_a[2] = -r;
-    m_a[0] = 1.;
-    m_a[1] = 0;
+    costh = (rr / (1. + rsq)) * cos(2 * pi * freq / sr);
+    // sin(acos(c)) is sqrt(1 - c^2), which the fast math mode uses directly
+    scal = (1 - rsq) * (prec == fastMath ? std::sqrt(1. - costh * costh) : sin(acos(costh)));
+    b[0] = -rr * costh;
+    b[1] = rsq;
+    a[2] = -r;
+    a[0] = 1.;
+    a[1] = 0;
 }
 
 void Reson::dsp() {
@@ -38,6 +47,19 @@ void Reson::dsp() {
         m_del[1] = m_del[0];
         m_s[i] = m_del[0] = y;
     }
+    flushDenormals(m_del, 2);
+}
+
+void Reson::filterSpan(const double* in, double* out, size_t frames, double* del) const
+{
+    double y;
+    for (size_t i = 0; i < frames; i++)
+    {
+        y = in[i] * m_scal - m_b[0] * del[0] - m_b[1] * del[1];
+        del[1] = del[0];
+        del[0] = y;
+        if (out != nullptr) out[i] = y;
+    }
 }
 
 void ResonZ::update()
@@ -10,22 +10,49 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "Rms.h"
+#include "Denormals.h"
 
 using namespace KiwiWaves;
 
-double Rms::rect(double x) { return x < 0.0 ? -x : x; }
-
 void Rms::dsp()
 {
-    for (size_t i = 0; i < m_s.size(); i++)
+    const double* in = m_sigIn.data();
+    size_t n = m_s.size();
+
+    // A fixed cutoff is a single run, read once per vector
+    for (size_t start = 0, end; start < n; start = end)
     {
-        if (m_freq != m_cutFreq[i])
+        end = m_cutFreq.runEnd(start, n);
+        if (m_freq != m_cutFreq[start])
         {
-            m_freq = m_cutFreq[i];
+            m_freq = m_cutFreq[start];
             update();
         }
 
-        m_del = m_a * rect(m_sigIn[i]) - m_b * m_del;
-        m_s[i] = m_del;
+        double a = m_a, b = m_b, del = m_del;
+        for (size_t i = start; i < end; i++)
+        {
+            del = a * rect(in[i]) - b * del;
+            m_s[i] = del;
+        }
+        m_del = del;
+    }
+    m_del = flushDenormal(m_del);
+}
+
+void Rms::processPair(const double* in1, const double* in2, double* out1, double* out2,
+    size_t n, double a, double b, double& del1, double& del2)
+{
+    // Both states in one array, so the pair of recursions is a vector operation
+    double del[2] = { del1, del2 };
+    for (size_t i = 0; i < n; i++)
+    {
+        double x[2] = { rect(in1[i]), rect(in2[i]) };
+        for (size_t k = 0; k < 2; k++)
+            del[k] = a * x[k] - b * del[k];
+        out1[i] = del[0];
+        out2[i] = del[1];
     }
-}
\ No newline at end of file
+    del1 = del[0];
+    del2 = del[1];
+}
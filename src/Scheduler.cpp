@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Scheduler and ControlSig classes
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Scheduler.h"
+#include <algorithm>
+
+using namespace KiwiWaves;
+
+void ControlSig::dsp()
+{
+    size_t n = m_s.size();
+
+    for (size_t i = 0; i < n;)
+    {
+        for (; m_events.next(n) == i; m_events.pop())
+            m_val = m_events.front().value;
+
+        size_t end = m_events.next(n);
+        std::fill(m_s.begin() + i, m_s.begin() + end, m_val);
+        i = end;
+    }
+    m_events.advance(n);
+}
+
+static bool retrigFn(void* target, size_t offset, double) { return static_cast<SegmentEnv*>(target)->scheduleRetrig(offset); }
+static bool releaseFn(void* target, size_t offset, double) { return static_cast<SegmentEnv*>(target)->scheduleRelease(offset); }
+static bool resetFn(void* target, size_t offset, double value) { return static_cast<Phasor*>(target)->resetAt(offset, value); }
+static bool resetOscFn(void* target, size_t offset, double value) { return static_cast<Osc*>(target)->resetAt(offset, value); }
+static bool setFn(void* target, size_t offset, double value) { return static_cast<ControlSig*>(target)->setAt(offset, value); }
+
+bool Scheduler::schedule(uint64_t time, EventFn fn, void* target, double value)
+{
+    // Never past the capacity reserved by the constructor
+    if (m_heap.size() == m_heap.capacity())
+        return false;
+
+    m_heap.push_back({ time, m_seq++, fn, target, value });
+    std::push_heap(m_heap.begin(), m_heap.end());
+    return true;
+}
+
+bool Scheduler::retrigAt(uint64_t time, SegmentEnv& env) { return schedule(time, retrigFn, &env); }
+bool Scheduler::releaseAt(uint64_t time, SegmentEnv& env) { return schedule(time, releaseFn, &env); }
+bool Scheduler::resetAt(uint64_t time, Phasor& ph, double phase) { return schedule(time, resetFn, &ph, phase); }
+bool Scheduler::resetAt(uint64_t time, Osc& osc, double phase) { return schedule(time, resetOscFn, &osc, phase); }
+bool Scheduler::setAt(uint64_t time, ControlSig& sig, double value) { return schedule(time, setFn, &sig, value); }
+
+void Scheduler::dsp()
+{
+    uint64_t end = m_time + m_s.size();
+    fillDataToZero();
+
+    while (!m_heap.empty() && m_heap.front().time < end)
+    {
+        Entry e = m_heap.front();
+        std::pop_heap(m_heap.begin(), m_heap.end());
+        m_heap.pop_back();
+
+        size_t offset = e.time > m_time ? (size_t)(e.time - m_time) : 0;
+        if (e.fn(e.target, offset, e.value))
+            m_s[offset] += 1.;
+        else
+        {
+            // The target queue is full until the target is processed, so
+            // the event waits for the next vector, ahead of the later ones
+            m_held.push_back(e);
+            m_deferred++;
+        }
+    }
+
+    for (const Entry& e : m_held)
+    {
+        m_heap.push_back(e);
+        std::push_heap(m_heap.begin(), m_heap.end());
+    }
+    m_held.clear();
+    m_time = end;
+}
@@ -10,25 +10,59 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "SegmentEnv.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace KiwiWaves;
 
 void SegmentEnv::dsp()
 {
-	if (!m_validVectorSizes)
-		return;
+	const double* gate = m_gate != nullptr ? m_gate->data() : nullptr;
+	size_t n = m_s.size();
 
-	for (size_t i = 0; i < m_s.size(); i++) {
-		m_s[i] = m_val + m_offset;
+	for (size_t i = 0; i < n;)
+	{
+		// Events at a sample take effect before it is generated
+		for (; m_events.next(n) == i; m_events.pop())
+			trigger(m_events.front().type);
+		if (gate != nullptr && (gate[i] > 0.) != m_gateOn)
+		{
+			m_gateOn = !m_gateOn;
+			trigger(m_gateOn ? retrigEvent : releaseEvent);
+		}
 
-		if (m_count < m_times[m_ind] * m_sr) {
-			if (m_curves[m_ind] == linear) m_val += m_incr;
-			else if (m_curves[m_ind] == exponential) m_val *= m_incr;
-			m_count++;
+		// Up to the next event or gate edge
+		size_t end = m_events.next(n);
+		if (gate != nullptr)
+		{
+			size_t edge = i + 1;
+			while (edge < end && (gate[edge] > 0.) == m_gateOn) edge++;
+			end = edge;
+		}
+
+		if (m_validVectorSizes) generate(i, end);
+		i = end;
+	}
+	m_events.advance(n);
+}
+
+void SegmentEnv::generate(size_t from, size_t to)
+{
+	double* out = m_s.data();
+
+	for (size_t i = from; i < to;) {
+		if (m_count < m_steps) {
+			// Closed form up to the end of the segment or of the span
+			size_t len = std::min((size_t)(m_steps - m_count), to - i);
+			if (m_curves[m_ind] == exponential) expSpan(out + i, len);
+			else linSpan(out + i, len);
+			m_count += (unsigned int)len;
+			m_val = m_curves[m_ind] == exponential ? m_start * pow(m_incr, (double)m_count) : m_start + m_count * m_incr;
+			i += len;
 		}
 		else
 		{
+			out[i++] = m_val + m_offset;
 			m_val = m_levels[m_ind + 1];
 			// Start the next segment only if there's more, except when the last segment is release.
 			// In that case, hold the end of the last two segments
@@ -36,12 +70,55 @@ void SegmentEnv::dsp()
 			{
 				startSegment(m_ind + 1);
 			}
+			else
+			{
+				std::fill(out + i, out + to, m_val + m_offset);
+				i = to;
+			}
+		}
+	}
+}
+
+void SegmentEnv::linSpan(double* out, size_t len)
+{
+	double base = m_start + m_count * m_incr + m_offset;
+	for (size_t k = 0; k < len; k++)
+		out[k] = base + (int)k * m_incr;
+}
+
+void SegmentEnv::expSpan(double* out, size_t len)
+{
+	// Four interleaved geometric series, anchored in closed form at the start of the span
+	double first = m_start * pow(m_incr, (double)m_count);
+	double step = m_incr * m_incr * m_incr * m_incr;
+	double x[4] = { first, first * m_incr, first * m_incr * m_incr, first * m_incr * m_incr * m_incr };
+	size_t k = 0;
+	for (; k + 4 <= len; k += 4)
+	{
+		for (size_t j = 0; j < 4; j++)
+		{
+			out[k + j] = x[j] + m_offset;
+			x[j] *= step;
 		}
 	}
+	for (size_t j = 0; k < len; k++, j++)
+		out[k] = x[j] + m_offset;
+}
+
+void SegmentEnv::trigger(EventType type)
+{
+	if (!m_validVectorSizes)
+		return;
+
+	if (type == retrigEvent) retrig();
+	else if (type == releaseEvent) release();
 }
 
 void SegmentEnv::retrig()
 {
+	if (!m_validVectorSizes)
+		return;
+
 	m_val = m_levels[0];
 	startSegment(0);
 }
@@ -58,6 +135,8 @@ void SegmentEnv::startSegment(unsigned int newSeg = 0)
 {
 	m_ind = newSeg;
 	m_count = 0;
+	m_start = m_val;
+	m_steps = m_times[m_ind] > 0. ? (unsigned int)std::ceil(m_times[m_ind] * sr()) : 0;
 
 	if (m_curves[m_ind] == exponential)
 	{
@@ -82,13 +161,9 @@ bool SegmentEnv::checkVectorSizes()
 {
 	m_validVectorSizes = true;
 
-	m_validVectorSizes &= (m_times.size() != m_curves.size());
+	m_validVectorSizes &= (m_times.size() == m_curves.size());
 	m_validVectorSizes &= (m_times.size() >= 1);
-	m_validVectorSizes &= (m_levels.size() >= 2);
 	m_validVectorSizes &= (m_levels.size() - m_times.size() == 1);
-	m_validVectorSizes &= (m_times.size() >= 2 && m_releaseSeg);
-	m_validVectorSizes &= (m_levels.size() >= 1 && m_releaseSeg);
-	m_validVectorSizes &= (m_curves.size() >= 1 && m_releaseSeg);
 
 	return m_validVectorSizes;
 }
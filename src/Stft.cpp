@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Stft class
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "Stft.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace KiwiWaves;
+
+Stft::Stft(UGen& signalIn, size_t fftSiz, size_t hop, size_t vsiz, double sr) :
+    m_sigIn(signalIn), m_fft(fftSiz), m_fill(0), UGen(vsiz, sr)
+{
+    size_t n = m_fft.size();
+    m_hop = hop > 0 && hop < n ? hop : n;
+
+    // Periodic Hann window, used for both analysis and synthesis
+    double sum = 0.;
+    m_win.resize(n);
+    for (size_t i = 0; i < n; i++)
+    {
+        m_win[i] = 0.5 - 0.5 * std::cos(twopi * i / n);
+        sum += m_win[i] * m_win[i];
+    }
+    m_norm = (double)m_hop / sum;
+
+    m_inBuf.assign(n, 0.);
+    m_acc.assign(n, 0.);
+    m_time.assign(n, 0.);
+    m_outBuf.assign(m_hop, 0.);
+    m_anaRe.assign(bins(), 0.);
+    m_anaIm.assign(bins(), 0.);
+    m_re.assign(bins(), 0.);
+    m_im.assign(bins(), 0.);
+}
+
+void Stft::magnitudes(double* mag) const
+{
+    for (size_t k = 0; k < m_anaRe.size(); k++)
+        mag[k] = std::sqrt(m_anaRe[k] * m_anaRe[k] + m_anaIm[k] * m_anaIm[k]);
+}
+
+void Stft::frame()
+{
+    size_t n = m_fft.size();
+
+    for (size_t i = 0; i < n; i++)
+        m_time[i] = m_inBuf[i] * m_win[i];
+    m_fft.forward(m_time.data(), m_anaRe.data(), m_anaIm.data());
+
+    std::memcpy(m_re.data(), m_anaRe.data(), bins() * sizeof(double));
+    std::memcpy(m_im.data(), m_anaIm.data(), bins() * sizeof(double));
+    processFrame(m_re.data(), m_im.data());
+
+    // Overlap-add, the first hop samples of the accumulator are then complete
+    m_fft.inverse(m_re.data(), m_im.data(), m_time.data());
+    for (size_t i = 0; i < n; i++)
+        m_acc[i] += m_time[i] * m_win[i] * m_norm;
+
+    std::memcpy(m_outBuf.data(), m_acc.data(), m_hop * sizeof(double));
+    std::memmove(m_acc.data(), m_acc.data() + m_hop, (n - m_hop) * sizeof(double));
+    std::fill(m_acc.end() - m_hop, m_acc.end(), 0.);
+    std::memmove(m_inBuf.data(), m_inBuf.data() + m_hop, (n - m_hop) * sizeof(double));
+}
+
+void Stft::dsp()
+{
+    const double* in = m_sigIn.data();
+    size_t n = m_fft.size();
+
+    for (size_t pos = 0; pos < m_s.size();)
+    {
+        size_t len = std::min(m_hop - m_fill, m_s.size() - pos);
+        std::memcpy(m_inBuf.data() + n - m_hop + m_fill, in + pos, len * sizeof(double));
+        std::memcpy(m_s.data() + pos, m_outBuf.data() + m_fill, len * sizeof(double));
+
+        m_fill += len;
+        pos += len;
+        if (m_fill == m_hop)
+        {
+            frame();
+            m_fill = 0;
+        }
+    }
+}
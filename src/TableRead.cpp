@@ -15,30 +15,39 @@
 
 using namespace KiwiWaves;
 
-double TableRead::getRawIndex(const size_t& indx)
+double TableRead::getRawIndex(double ind)
 {
-	double tabPos = m_ind[indx] * (m_norm ? m_table.size() : 1); // normalization to table size scale
-	if (m_wrap) tabPos = fmod(tabPos, m_table.size()); // wrap
-	else tabPos = std::max(0., std::min(tabPos, (double)m_table.size())); // clamp
+	double tsiz = (double)m_table.size();
+	double tabPos = ind * (m_norm ? tsiz : 1); // normalization to table size scale
+	if (m_wrap)
+	{
+		tabPos = fmod(tabPos, tsiz); // wrap, negative positions from the end
+		if (tabPos < 0.) tabPos = tabPos + tsiz < tsiz ? tabPos + tsiz : 0.;
+	}
+	else tabPos = std::max(0., std::min(tabPos, tsiz - 1.)); // clamp to the last sample
 	return tabPos;
 }
 
 void TableRead::dsp()
 {
+	UGenParam::Block ind = m_ind.block();
+	const double* tab = m_table.data();
 	for (size_t i = 0; i < m_s.size(); i++)
-		m_s[i] = m_table[(int)getRawIndex(i)]; // truncation
+		m_s[i] = tab[(int)getRawIndex(ind[i])]; // truncation
 }
 
 void TableReadI::dsp()
 {
 	double raw, a, b;
-	size_t posi, s = m_s.size();
-	for (size_t i = 0; i < s ; i++)
+	size_t posi, n = m_s.size(), s = m_table.size();
+	UGenParam::Block ind = m_ind.block();
+	const double* tab = m_table.data();
+	for (size_t i = 0; i < n; i++)
 	{
-		raw = getRawIndex(i);
+		raw = getRawIndex(ind[i]);
 		posi = (unsigned int)raw;
-		a = m_table[posi];
-		b = posi < s - 1 ? m_table[posi + 1] : m_table[0];
+		a = tab[posi];
+		b = posi < s - 1 ? tab[posi + 1] : tab[0];
 		m_s[i] = a + (raw - (double)posi) * (b - a); // linear interpolation
 	}
 }
@@ -48,16 +57,18 @@ void TableReadC::dsp()
 	double frac, raw;
 	double a, b, c, d;
 	double tmp, fracsq, fracb;
-	size_t posi, s = m_s.size();
-	for (size_t i = 0; i < s; i++)
+	size_t posi, n = m_s.size(), s = m_table.size();
+	UGenParam::Block ind = m_ind.block();
+	const double* tab = m_table.data();
+	for (size_t i = 0; i < n; i++)
 	{
-		raw = getRawIndex(i);
+		raw = getRawIndex(ind[i]);
 		posi = (int)raw;
 		frac = raw - posi;
-		a = posi > 0 ? m_table[posi - 1] : m_table[s - 1];
-		b = m_table[posi];
-		c = posi + 1 < s ? m_table[posi + 1] : m_table[0];
-		d = posi + 2 < s ? m_table[posi + 2] : m_table[posi + 2 - s];
+		a = posi > 0 ? tab[posi - 1] : tab[s - 1];
+		b = tab[posi];
+		c = posi + 1 < s ? tab[posi + 1] : tab[0];
+		d = posi + 2 < s ? tab[posi + 2] : tab[posi + 2 - s];
 		tmp = d + 3.f * b;
 		fracsq = frac * frac;
 		fracb = frac * fracsq;
@@ -10,6 +10,7 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "Tone.h"
+#include "Denormals.h"
 #include <cmath>
 
 using namespace KiwiWaves;
@@ -27,18 +28,29 @@ void ToneLP::dsp()
         m_del = m_a * m_sigIn[i] - m_b * m_del;
         m_s[i] = m_del;
     }
+    m_del = flushDenormal(m_del);
 }
 
 void ToneLP::update()
 {
-    double costh = 2. - cos(2. * pi * m_freq / m_sr);
-    m_b = sqrt(costh * costh - 1.) - costh;
-    m_a = (1. + m_b);
+    coefs(m_freq, m_sr, m_a, m_b);
+}
+
+void ToneLP::coefs(double freq, double sr, double& a, double& b)
+{
+    double costh = 2. - cos(2. * pi * freq / sr);
+    b = sqrt(costh * costh - 1.) - costh;
+    a = (1. + b);
 }
 
 void ToneHP::update()
 {
-    double costh = 2. + cos(2. * pi * m_freq / m_sr);
-    m_b = costh - sqrt(costh * costh - 1.);
-    m_a = (1. + m_b);
+    coefs(m_freq, m_sr, m_a, m_b);
+}
+
+void ToneHP::coefs(double freq, double sr, double& a, double& b)
+{
+    double costh = 2. + cos(2. * pi * freq / sr);
+    b = costh - sqrt(costh * costh - 1.);
+    a = (1. + b);
 }
@@ -0,0 +1,199 @@
+////////////////////////////////////////////////////////////////////
+// Implementation of the Trace rings and their Chrome trace export
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "KiwiWaves.h"
+#ifdef KIWIWAVES_TRACE
+#include "Trace.h"
+#include "Profile.h"
+#include "UGen.h"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+using namespace KiwiWaves;
+
+static_assert((def_trace_capacity & (def_trace_capacity - 1)) == 0, "def_trace_capacity must be a power of two");
+
+/** Begin or end event of the processing of a UGen (type is set)
+	or of a named span (what is the name).
+*/
+struct TraceEvent
+{
+    uint64_t ticks;
+    const std::type_info* type;
+    const void* what;
+    bool begin;
+};
+
+/** Events of a thread. Only that thread writes them, and the head
+    counts every event ever recorded.
+*/
+struct TraceRing
+{
+    TraceRing(size_t id) : events(def_trace_capacity), head(0), id(id), name(nullptr) { };
+
+    std::vector<TraceEvent> events;
+    std::atomic<uint64_t> head;
+    size_t id;
+    std::atomic<const char*> name;
+};
+
+static std::mutex ringsMutex;
+static std::vector<std::unique_ptr<TraceRing>> rings;
+static std::atomic<bool> enabled(true);
+static thread_local TraceRing* threadRing = nullptr;
+
+static TraceRing& ring()
+{
+    if (threadRing == nullptr)
+    {
+        // The rings outlive their threads, so that they can be exported later
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.emplace_back(new TraceRing(rings.size()));
+        threadRing = rings.back().get();
+    }
+    return *threadRing;
+}
+
+static inline void record(const std::type_info* type, const void* what, bool begin)
+{
+    if (!enabled.load(std::memory_order_relaxed))
+        return;
+
+    TraceRing& r = ring();
+    uint64_t h = r.head.load(std::memory_order_relaxed);
+    TraceEvent& e = r.events[h & (def_trace_capacity - 1)];
+    e.ticks = Profile::ticks();
+    e.type = type;
+    e.what = what;
+    e.begin = begin;
+    r.head.store(h + 1, std::memory_order_release);
+}
+
+void Trace::begin(const UGen& ugen)
+{
+    record(&typeid(ugen), &ugen, true);
+}
+
+void Trace::end(const UGen& ugen)
+{
+    record(&typeid(ugen), &ugen, false);
+}
+
+void Trace::begin(const char* name)
+{
+    record(nullptr, name, true);
+}
+
+void Trace::end(const char* name)
+{
+    record(nullptr, name, false);
+}
+
+void Trace::setThreadName(const char* name)
+{
+    ring().name.store(name, std::memory_order_relaxed);
+}
+
+void Trace::enable(bool on)
+{
+    enabled.store(on, std::memory_order_relaxed);
+}
+
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    for (std::unique_ptr<TraceRing>& r : rings)
+        r->head.store(0, std::memory_order_release);
+}
+
+static std::string jsonString(const char* s)
+{
+    std::string out = "\"";
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\') out += '\\';
+        if ((unsigned char)*s >= 0x20) out += *s;
+    }
+    return out + "\"";
+}
+
+/** Write the begin or end of a span of thread tid, at us microseconds.
+*/
+static void writeEvent(std::ostream& os, const TraceEvent& span, bool begin, double us, size_t tid)
+{
+    char line[128];
+    os << ",\n{\"name\":" << (span.type ? jsonString(Profile::typeName(*span.type).c_str())
+        : jsonString((const char*)span.what));
+    std::snprintf(line, sizeof(line), ",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%zu",
+        span.type ? "ugen" : "span", begin ? 'B' : 'E', us, tid);
+    os << line;
+    if (span.type && begin)
+    {
+        std::snprintf(line, sizeof(line), ",\"args\":{\"ugen\":\"%p\"}", span.what);
+        os << line;
+    }
+    os << "}";
+}
+
+void Trace::write(std::ostream& os)
+{
+    std::lock_guard<std::mutex> lock(ringsMutex);
+
+    // Timestamps in microseconds from the first event kept in any ring
+    uint64_t t0 = UINT64_MAX;
+    for (std::unique_ptr<TraceRing>& r : rings)
+    {
+        uint64_t h = r->head.load(std::memory_order_acquire);
+        uint64_t first = h > def_trace_capacity ? h - def_trace_capacity : 0;
+        if (h > 0 && r->events[first & (def_trace_capacity - 1)].ticks < t0)
+            t0 = r->events[first & (def_trace_capacity - 1)].ticks;
+    }
+    double usPerTick = 1e6 / Profile::ticksPerSecond();
+
+    os << "{\"traceEvents\":[\n";
+    os << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"KiwiWaves\"}}";
+    for (std::unique_ptr<TraceRing>& r : rings)
+    {
+        const char* threadName = r->name.load(std::memory_order_relaxed);
+        std::string name = threadName ? threadName : "thread " + std::to_string(r->id);
+        os << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << r->id
+            << ",\"args\":{\"name\":" << jsonString(name.c_str()) << "}}";
+
+        // The ring may have overwritten the begins of its first ends, and
+        // the last begins may not have ended: keep the spans balanced
+        uint64_t h = r->head.load(std::memory_order_acquire);
+        uint64_t first = h > def_trace_capacity ? h - def_trace_capacity : 0;
+        std::vector<const TraceEvent*> open;
+        uint64_t last = t0;
+        for (uint64_t k = first; k < h; k++)
+        {
+            const TraceEvent& e = r->events[k & (def_trace_capacity - 1)];
+            if (e.begin)
+                open.push_back(&e);
+            else if (open.empty())
+                continue;
+            else
+                open.pop_back();
+            writeEvent(os, e, e.begin, (e.ticks - t0) * usPerTick, r->id);
+            last = e.ticks;
+        }
+        for (; !open.empty(); open.pop_back())
+            writeEvent(os, *open.back(), false, (last - t0) * usPerTick, r->id);
+    }
+    os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+#endif
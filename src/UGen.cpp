@@ -10,12 +10,36 @@
 //
 /////////////////////////////////////////////////////////////////////
 #include "UGen.h"
+#ifdef KIWIWAVES_TRACE
+#include "Trace.h"
+#endif
 
 using namespace KiwiWaves;
 
+#ifdef KIWIWAVES_PROFILE
+// Ticks spent in the UGens processed from the dsp() being timed,
+// so that each UGen is only charged for its own work
+static thread_local uint64_t childTicks = 0;
+#endif
+
 const double* UGen::process()
 {
+#ifdef KIWIWAVES_TRACE
+	Trace::begin(*this);
+#endif
+#ifdef KIWIWAVES_PROFILE
+	uint64_t outer = childTicks, start = Profile::ticks();
+	childTicks = 0;
+	dsp();
+	uint64_t total = Profile::ticks() - start;
+	m_prof.add(total > childTicks ? total - childTicks : 0, m_s.size());
+	childTicks = outer + total;
+#else
 	dsp();
+#endif
+#ifdef KIWIWAVES_TRACE
+	Trace::end(*this);
+#endif
 	return m_s.data();
 }
 
@@ -0,0 +1,402 @@
+/////////////////////////////////////////////////////////////////////
+// Reference: scalar reference implementations of the DSP kernels
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _REFERENCE_H_
+#define _REFERENCE_H_
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "KiwiWaves.h"
+
+namespace KiwiWaves
+{
+
+/** Scalar reference implementations of the UGen kernels. They process
+	a whole signal one sample at a time with the standard library math,
+	as the UGens did before any block, table or approximated path was
+	added, and are kept as simple as possible: the optimized UGens are
+	tested against them, not the other way round.
+*/
+namespace Reference
+{
+	/** Phasor: phase before the increment, wrapped to [0, 1). \n
+		fr - frequency of every sample. \n
+		ph - initial phase. \n
+		sr - sampling rate. \n
+		resets - (sample, phase) pairs applied before their sample, in order.
+	*/
+	inline std::vector<double> phasor(const std::vector<double>& fr, double ph, double sr,
+		const std::vector<std::pair<size_t, double>>& resets = {})
+	{
+		std::vector<double> out(fr.size());
+		size_t r = 0;
+		for (size_t i = 0; i < fr.size(); i++)
+		{
+			for (; r < resets.size() && resets[r].first == i; r++)
+				ph = resets[r].second - std::floor(resets[r].second);
+			out[i] = ph;
+			ph += fr[i] / sr;
+			ph = ph - std::floor(ph);
+		}
+		return out;
+	}
+
+	/** Table position of an index, wrapped or clamped to the last sample.
+	*/
+	inline double tablePos(double idx, size_t tsiz, bool norm, bool wrap)
+	{
+		double pos = idx * (norm ? (double)tsiz : 1.);
+		if (wrap)
+		{
+			pos = std::fmod(pos, (double)tsiz);
+			if (pos < 0.) pos = pos + tsiz < tsiz ? pos + tsiz : 0.;
+			return pos;
+		}
+		return std::max(0., std::min(pos, tsiz - 1.));
+	}
+
+	/** Table lookup with truncation (order 0), linear (1) or cubic (3)
+		interpolation. The neighbours of a position wrap around the table.
+	*/
+	inline std::vector<double> tableRead(const std::vector<double>& index, const std::vector<double>& tab,
+		bool norm, bool wrap, int order)
+	{
+		size_t s = tab.size();
+		std::vector<double> out(index.size());
+		for (size_t i = 0; i < index.size(); i++)
+		{
+			double raw = tablePos(index[i], s, norm, wrap);
+			size_t posi = (size_t)raw;
+			double frac = raw - posi;
+			double b = tab[posi], c = tab[(posi + 1) % s];
+			if (order == 0) out[i] = b;
+			else if (order == 1) out[i] = b + frac * (c - b);
+			else
+			{
+				double a = tab[(posi + s - 1) % s], d = tab[(posi + 2) % s];
+				double tmp = d + 3. * b, fracsq = frac * frac;
+				out[i] = frac * fracsq * (-a - 3. * c + tmp) / 6. + fracsq * ((a + c) / 2. - b) +
+					frac * (c + (-2. * a - tmp) / 6.) + b;
+			}
+		}
+		return out;
+	}
+
+	/** Table oscillator: a phasor reading a normalized, wrapped table. \n
+		amp, fr - amplitude and frequency of every sample. \n
+		tab - table. \n
+		ph - initial phase. \n
+		dco - DC offset. \n
+		sr - sampling rate. \n
+		order - interpolation order of the table lookup.
+	*/
+	inline std::vector<double> osc(const std::vector<double>& amp, const std::vector<double>& fr,
+		const std::vector<double>& tab, double ph, double dco, double sr, int order)
+	{
+		std::vector<double> out = tableRead(phasor(fr, ph, sr), tab, true, true, order);
+		for (size_t i = 0; i < out.size(); i++)
+			out[i] = out[i] * amp[i] + dco;
+		return out;
+	}
+
+	/** Second order filters of the library.
+	*/
+	enum Filter { lowPass, highPass, bandPass, bandReject, resonR, resonZ, reson };
+
+	/** Coefficients of a second order filter, as in the original UGens.
+	*/
+	inline void filterCoefs(Filter f, double freq, double band, double sr, double* a, double* b, double& scal)
+	{
+		scal = 1.;
+		if (f == lowPass || f == highPass)
+		{
+			double l = f == lowPass ? 1 / std::tan(pi * freq / sr) : std::tan(pi * freq / sr);
+			double sqrt2l = std::sqrt(2.) * l;
+			double lsq = l * l;
+			a[0] = 1. / (1. + sqrt2l + lsq);
+			a[1] = (f == lowPass ? 2. : -2.) * a[0];
+			a[2] = a[0];
+			b[0] = 2. * (f == lowPass ? 1. - lsq : lsq - 1.) * a[0];
+			b[1] = (1. - sqrt2l + lsq) * a[0];
+		}
+		else if (f == bandPass)
+		{
+			double l = 1. / std::tan(pi * band / sr);
+			double cosl = 2. * std::cos(2 * pi * freq / sr);
+			a[0] = 1. / (1. + l);
+			a[1] = 0;
+			a[2] = -a[0];
+			b[0] = -l * cosl * a[0];
+			b[1] = (l - 1.) * a[0];
+		}
+		else if (f == bandReject)
+		{
+			double l = std::tan(pi * band / sr);
+			double cosl = 2. * std::cos(2 * pi * freq / sr);
+			a[0] = 1. / (1. + l);
+			a[1] = -cosl * a[0];
+			a[2] = a[0];
+			b[0] = a[1];
+			b[1] = (1. - l) * a[0];
+		}
+		else
+		{
+			double r = std::exp(-band * pi / sr);
+			double rr = 2. * r, rsq = r * r;
+			double costh = (rr / (1. + rsq)) * std::cos(2 * pi * freq / sr);
+			scal = (1 - rsq) * std::sin(std::acos(costh));
+			b[0] = -rr * costh;
+			b[1] = rsq;
+			a[0] = 1.;
+			a[1] = 0.;
+			a[2] = f == resonR ? -r : (f == resonZ ? -1. : 0.);
+		}
+	}
+
+	/** Second order filter in Direct Form II, with the coefficients
+		computed again whenever a parameter changes. \n
+		in - input signal. \n
+		freq, band - cutoff or centre frequency and bandwidth of every sample. \n
+		sr - sampling rate.
+	*/
+	inline std::vector<double> filter(Filter f, const std::vector<double>& in, const std::vector<double>& freq,
+		const std::vector<double>& band, double sr)
+	{
+		std::vector<double> out(in.size());
+		double a[3] = {}, b[2] = {}, scal = 1., del[2] = { 0., 0. }, lastF = NAN, lastB = NAN;
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			if (freq[i] != lastF || band[i] != lastB)
+			{
+				lastF = freq[i];
+				lastB = band[i];
+				filterCoefs(f, lastF, lastB, sr, a, b, scal);
+			}
+			double w = scal * in[i] - b[0] * del[0] - b[1] * del[1];
+			out[i] = w * a[0] + a[1] * del[0] + a[2] * del[1];
+			del[1] = del[0];
+			del[0] = w;
+		}
+		return out;
+	}
+
+	/** Second order filter in Direct Form II with fixed coefficients.
+	*/
+	inline std::vector<double> biquad(const std::vector<double>& in, const double* a, const double* b)
+	{
+		std::vector<double> out(in.size());
+		double del[2] = { 0., 0. };
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			double w = in[i] - b[0] * del[0] - b[1] * del[1];
+			out[i] = w * a[0] + a[1] * del[0] + a[2] * del[1];
+			del[1] = del[0];
+			del[0] = w;
+		}
+		return out;
+	}
+
+	/** First order low-pass or high-pass filter, optionally on the
+		rectified input as in Rms.
+	*/
+	inline std::vector<double> tone(const std::vector<double>& in, const std::vector<double>& freq, double sr,
+		bool highPass, bool rectify = false)
+	{
+		std::vector<double> out(in.size());
+		double a = 0., b = 0., del = 0., last = NAN;
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			if (freq[i] != last)
+			{
+				last = freq[i];
+				double costh = highPass ? 2. + std::cos(2. * pi * last / sr) : 2. - std::cos(2. * pi * last / sr);
+				b = highPass ? costh - std::sqrt(costh * costh - 1.) : std::sqrt(costh * costh - 1.) - costh;
+				a = 1. + b;
+			}
+			del = a * (rectify ? std::fabs(in[i]) : in[i]) - b * del;
+			out[i] = del;
+		}
+		return out;
+	}
+
+	/** Balance: in scaled by the ratio of the RMS estimates of comp and in.
+	*/
+	inline std::vector<double> balance(const std::vector<double>& in, const std::vector<double>& comp,
+		const std::vector<double>& freq, double sr, ZeroHandlingMode mode)
+	{
+		std::vector<double> rmsSig = tone(in, freq, sr, false, true);
+		std::vector<double> rmsComp = tone(comp, freq, sr, false, true);
+		std::vector<double> out(in.size());
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			if (mode == equalToOne)
+				out[i] = in[i] * (rmsSig[i] > 0. ? rmsComp[i] / rmsSig[i] : 1.);
+			else
+				out[i] = in[i] * (rmsComp[i] / (rmsSig[i] > 0. ? rmsSig[i] : min_double));
+		}
+		return out;
+	}
+
+	/** Delay line with feedback, reading ceil(del) samples back and
+		interpolating towards the next written sample. Delays must be of
+		one sample at least. \n
+		in - input signal. \n
+		del - delay of every sample, in seconds. \n
+		fb - feedback of every sample, or RT60 if comb is true. \n
+		maxDel - maximum delay, in seconds. \n
+		sr - sampling rate. \n
+		interp - linear interpolation. \n
+		comb - the feedback is computed from the RT60 as in Comb.
+	*/
+	inline std::vector<double> delay(const std::vector<double>& in, const std::vector<double>& del,
+		const std::vector<double>& fb, double maxDel, double sr, bool interp, bool comb = false)
+	{
+		std::vector<double> line(in.size(), 0.), out(in.size());
+		double maxSamples = std::ceil(maxDel * sr);
+		for (size_t t = 0; t < in.size(); t++)
+		{
+			double d = std::min(del[t] * sr, maxSamples);
+			size_t offs = (size_t)std::ceil(d);
+			double a = t >= offs ? line[t - offs] : 0.;
+			double b = t + 1 >= offs && offs > 1 ? line[t + 1 - offs] : a;
+			out[t] = interp ? a + ((double)offs - d) * (b - a) : a;
+
+			double g = comb ? std::pow(0.001, del[t] / fb[t]) : fb[t];
+			line[t] = in[t] + out[t] * g;
+		}
+		return out;
+	}
+
+	/** Multi-segment envelope generated one sample at a time with
+		a constant increment or ratio per segment. \n
+		levels, times, curves - segments of the envelope. \n
+		offset - value added to the output. \n
+		releaseSeg - the last segment waits for a release. \n
+		sr - sampling rate. \n
+		n - number of samples. \n
+		events - (sample, retrig or release) pairs applied before their sample, in order.
+	*/
+	inline std::vector<double> segmentEnv(std::vector<double> levels, const std::vector<double>& times,
+		const std::vector<Curve>& curves, double offset, bool releaseSeg, double sr, size_t n,
+		const std::vector<std::pair<size_t, EventType>>& events = {})
+	{
+		size_t ind = 0, count = 0, ev = 0;
+		double val = levels[0], incr = 0.;
+		auto start = [&](size_t seg)
+		{
+			ind = seg;
+			count = 0;
+			if (curves[ind] == exponential)
+			{
+				for (size_t k = ind; k <= ind + 1; k++)
+				{
+					double other = levels[k == ind ? ind + 1 : ind];
+					if (levels[k] == 0.) levels[k] = other >= 0. ? imperceptible_db : -imperceptible_db;
+				}
+				incr = std::pow(levels[ind + 1] / levels[ind], 1 / (times[ind] * sr));
+			}
+			else
+				incr = (levels[ind + 1] - levels[ind]) / (times[ind] * sr);
+		};
+		start(0);
+
+		std::vector<double> out(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (; ev < events.size() && events[ev].first == i; ev++)
+			{
+				if (events[ev].second == retrigEvent)
+				{
+					val = levels[0];
+					start(0);
+				}
+				else if (events[ev].second == releaseEvent && releaseSeg)
+					start(times.size() - 1);
+			}
+
+			out[i] = val + offset;
+			if (count < times[ind] * sr)
+			{
+				val = curves[ind] == exponential ? val * incr : val + incr;
+				count++;
+			}
+			else
+			{
+				val = levels[ind + 1];
+				if ((int)ind < (int)times.size() - 2 || (!releaseSeg && ind < times.size() - 1))
+					start(ind + 1);
+			}
+		}
+		return out;
+	}
+
+	/** Discrete Fourier transform of a real signal, bins 0 to n/2.
+	*/
+	inline void dft(const std::vector<double>& in, std::vector<double>& re, std::vector<double>& im)
+	{
+		size_t n = in.size();
+		re.assign(n / 2 + 1, 0.);
+		im.assign(n / 2 + 1, 0.);
+		for (size_t k = 0; k <= n / 2; k++)
+		{
+			long double sr = 0., si = 0.;
+			for (size_t j = 0; j < n; j++)
+			{
+				// The product is reduced modulo n so the angle stays exact
+				long double ang = -2. * pi * (long double)((k * j) % n) / n;
+				sr += in[j] * std::cos(ang);
+				si += in[j] * std::sin(ang);
+			}
+			re[k] = (double)sr;
+			im[k] = (double)si;
+		}
+	}
+
+	/** Direct convolution, delayed by latency samples.
+	*/
+	inline std::vector<double> convolve(const std::vector<double>& in, const std::vector<double>& ir, size_t latency = 0)
+	{
+		std::vector<double> out(in.size(), 0.);
+		for (size_t t = latency; t < in.size(); t++)
+		{
+			long double acc = 0.;
+			for (size_t k = 0; k < ir.size() && k <= t - latency; k++)
+				acc += ir[k] * in[t - latency - k];
+			out[t] = (double)acc;
+		}
+		return out;
+	}
+
+	/** Windowed RMS or peak of the last win samples, read after each
+		group of decim samples and at the end of every vector of vsiz.
+	*/
+	inline std::vector<double> meter(const std::vector<double>& in, size_t win, size_t decim, size_t vsiz, bool peak)
+	{
+		std::vector<double> out;
+		for (size_t v = 0; v < in.size(); v += vsiz)
+		{
+			for (size_t g = v; g < v + vsiz; g += decim)
+			{
+				size_t last = std::min(g + decim, v + vsiz) - 1;
+				double acc = 0.;
+				for (size_t j = last + 1 > win ? last + 1 - win : 0; j <= last; j++)
+					acc = peak ? std::max(acc, std::fabs(in[j])) : acc + in[j] * in[j];
+				out.push_back(peak ? acc : std::sqrt(acc / win));
+			}
+		}
+		return out;
+	}
+}
+
+}
+
+#endif
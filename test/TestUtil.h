@@ -0,0 +1,256 @@
+/////////////////////////////////////////////////////////////////////
+// Test utilities: random signals, block feeding and error bounds
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#ifndef _TESTUTIL_H_
+#define _TESTUTIL_H_
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "UGen.h"
+
+namespace KiwiWaves
+{
+namespace Test
+{
+
+/** Deterministic random generator, so that every run of a test sees
+	the same parameters and a failure can be reproduced.
+*/
+class Random
+{
+public:
+	Random(uint64_t seed = 12345) : m_state(seed * 2862933555777941757ULL + 3037000493ULL) { };
+
+	/** Uniform value in [lo, hi).
+	*/
+	double uniform(double lo = 0., double hi = 1.)
+	{
+		m_state ^= m_state << 13;
+		m_state ^= m_state >> 7;
+		m_state ^= m_state << 17;
+		return lo + (hi - lo) * (double)(m_state >> 11) / 9007199254740992.;
+	}
+
+	/** Uniform integer in [lo, hi].
+	*/
+	size_t integer(size_t lo, size_t hi) { return lo + (size_t)uniform(0., (double)(hi - lo + 1)); }
+
+	/** White noise of n samples in [-amp, amp).
+	*/
+	std::vector<double> noise(size_t n, double amp = 1.)
+	{
+		std::vector<double> out(n);
+		for (double& x : out) x = uniform(-amp, amp);
+		return out;
+	}
+
+	/** Modulation signal of n samples in [lo, hi): a random walk held
+		for runs of random length, so that both the per-sample and the
+		per-run paths of the UGens get exercised.
+	*/
+	std::vector<double> control(size_t n, double lo, double hi, size_t maxRun = 96)
+	{
+		std::vector<double> out(n);
+		double val = uniform(lo, hi);
+		for (size_t i = 0; i < n;)
+		{
+			size_t run = integer(1, maxRun);
+			for (size_t k = 0; k < run && i < n; k++, i++) out[i] = val;
+			val += uniform(-0.2, 0.2) * (hi - lo);
+			val = val < lo ? lo : (val >= hi ? lo + (hi - lo) * uniform(0.5, 1.) : val);
+		}
+		return out;
+	}
+
+private:
+	uint64_t m_state;
+};
+
+/** UGen that plays a precomputed signal one vector at a time. The
+	position is given by a shared block counter, so processing it more
+	than once per block (as the Iir filters do with their input) gives
+	the same vector.
+*/
+class Feed : public UGen
+{
+public:
+	Feed(const std::vector<double>& src, const size_t& block, size_t vsiz, double sr = def_sr) :
+		m_src(src), m_block(block), UGen(vsiz, sr) { };
+
+protected:
+	const std::vector<double>& m_src;
+	const size_t& m_block;
+
+	void dsp() override
+	{
+		for (size_t i = 0; i < m_s.size(); i++)
+		{
+			size_t pos = m_block * m_s.size() + i;
+			m_s[i] = pos < m_src.size() ? m_src[pos] : 0.;
+		}
+	}
+};
+
+/** UGen that plays a precomputed signal, one vector on every call to
+	process(), for the UGens that pull their input at their own rate.
+*/
+class Stream : public UGen
+{
+public:
+	Stream(const std::vector<double>& src, size_t vsiz, double sr = def_sr) :
+		m_src(src), m_pos(0), UGen(vsiz, sr) { };
+
+protected:
+	const std::vector<double>& m_src;
+	size_t m_pos;
+
+	void dsp() override
+	{
+		for (size_t i = 0; i < m_s.size(); i++, m_pos++)
+			m_s[i] = m_pos < m_src.size() ? m_src[m_pos] : 0.;
+	}
+};
+
+/** Run a UGen over a number of blocks and get its whole output.
+	The feeds are processed before the UGen on every block. \n
+	u - UGen under test. \n
+	block - block counter shared with the feeds. \n
+	blocks - number of blocks. \n
+	feeds - UGens to process before u.
+*/
+inline std::vector<double> render(UGen& u, size_t& block, size_t blocks, const std::vector<UGen*>& feeds = {})
+{
+	std::vector<double> out;
+	for (block = 0; block < blocks; block++)
+	{
+		for (UGen* f : feeds) f->process();
+		const double* s = u.process();
+		out.insert(out.end(), s, s + u.vsize());
+	}
+	return out;
+}
+
+/** Distance in units in the last place between two doubles.
+*/
+inline uint64_t ulpDistance(double a, double b)
+{
+	if (a == b) return 0;
+	if (std::isnan(a) || std::isnan(b)) return UINT64_MAX;
+	int64_t ia, ib;
+	std::memcpy(&ia, &a, sizeof(a));
+	std::memcpy(&ib, &b, sizeof(b));
+	ia = ia < 0 ? INT64_MIN - ia : ia;
+	ib = ib < 0 ? INT64_MIN - ib : ib;
+	return ia > ib ? (uint64_t)ia - (uint64_t)ib : (uint64_t)ib - (uint64_t)ia;
+}
+
+/** Largest error of out against ref in dB relative to the peak
+	of ref (-inf if identical, +inf if a sample is NaN).
+*/
+inline double errorDb(const std::vector<double>& ref, const std::vector<double>& out)
+{
+	double err = 0., peak = 0.;
+	for (size_t i = 0; i < ref.size(); i++)
+	{
+		double d = i < out.size() ? std::fabs(out[i] - ref[i]) : std::fabs(ref[i]);
+		if (std::isnan(d)) return INFINITY;
+		err = d > err ? d : err;
+		peak = std::fabs(ref[i]) > peak ? std::fabs(ref[i]) : peak;
+	}
+	return 20. * std::log10(err / (peak > 0. ? peak : 1.));
+}
+
+/** Least-squares fit of a sinusoid of known frequency to a signal. \n
+	x - signal. \n
+	w - frequency in radians per sample. \n
+	Returns the fitted sinusoid, as many samples as x.
+*/
+inline std::vector<double> sineFit(const std::vector<double>& x, double w)
+{
+	double ss = 0., sc = 0., cc = 0., xs = 0., xc = 0.;
+	for (size_t i = 0; i < x.size(); i++)
+	{
+		double s = std::sin(w * i), c = std::cos(w * i);
+		ss += s * s; sc += s * c; cc += c * c;
+		xs += x[i] * s; xc += x[i] * c;
+	}
+	double det = ss * cc - sc * sc;
+	double a = (xs * cc - xc * sc) / det, b = (xc * ss - xs * sc) / det;
+	std::vector<double> fit(x.size());
+	for (size_t i = 0; i < x.size(); i++)
+		fit[i] = a * std::sin(w * i) + b * std::cos(w * i);
+	return fit;
+}
+
+/** Counts the checks of a test program and reports the failed ones.
+*/
+class Suite
+{
+public:
+	Suite(const char* name) : m_name(name), m_checks(0), m_failed(0) { };
+
+	/** Check a condition. \n
+		what - description of the check. \n
+		ok - result. \n
+		detail - measured value, printed on failure.
+	*/
+	bool check(const std::string& what, bool ok, const std::string& detail = "")
+	{
+		m_checks++;
+		if (!ok)
+		{
+			m_failed++;
+			std::fprintf(stderr, "FAIL %s: %s %s\n", m_name.c_str(), what.c_str(), detail.c_str());
+		}
+		return ok;
+	}
+
+	/** Check that the largest error of out against ref is below bound dB.
+	*/
+	bool expectDb(const std::string& what, const std::vector<double>& ref, const std::vector<double>& out, double bound)
+	{
+		double db = errorDb(ref, out);
+		return check(what, ref.size() == out.size() && db <= bound, "(" + std::to_string(db) + " dB, bound "
+			+ std::to_string(bound) + " dB)");
+	}
+
+	/** Check that every sample of out is within maxUlp of ref.
+	*/
+	bool expectUlp(const std::string& what, const std::vector<double>& ref, const std::vector<double>& out, uint64_t maxUlp)
+	{
+		uint64_t worst = ref.size() == out.size() ? 0 : UINT64_MAX;
+		for (size_t i = 0; i < ref.size() && i < out.size(); i++)
+		{
+			uint64_t d = ulpDistance(ref[i], out[i]);
+			worst = d > worst ? d : worst;
+		}
+		return check(what, worst <= maxUlp, "(" + std::to_string(worst) + " ulp, bound " + std::to_string(maxUlp) + ")");
+	}
+
+	/** Print the summary and get the exit code of the test program.
+	*/
+	int finish() const
+	{
+		std::printf("%s: %zu checks, %zu failed\n", m_name.c_str(), m_checks, m_failed);
+		return m_failed == 0 ? 0 : 1;
+	}
+
+private:
+	std::string m_name;
+	size_t m_checks, m_failed;
+};
+
+}
+}
+
+#endif
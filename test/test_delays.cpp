@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////
+// test_delays: Delay and Comb against their scalar references
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Reference.h"
+#include "Delay.h"
+#include "Comb.h"
+#include "MultiTap.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t length = 8000;
+
+static std::string name(const char* ugen, const std::string& variant, size_t v, bool interp)
+{
+    return std::string(ugen) + " " + variant + " vsize " + std::to_string(v) + (interp ? " interp" : "");
+}
+
+static void testDelay(Suite& suite, Random& rnd, size_t v, bool interp)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    double maxDel = rnd.uniform(0.0005, 0.05);
+
+    // Delays of one sample at least, so the read never passes the write
+    std::vector<double> in = rnd.noise(n);
+    std::vector<double> del = rnd.control(n, 1. / def_sr, maxDel), fb = rnd.control(n, -0.9, 0.9);
+    Feed inFeed(in, block, v), delFeed(del, block, v), fbFeed(fb, block, v);
+    std::vector<UGen*> feeds = { &inFeed, &delFeed, &fbFeed };
+
+    // Fixed delays take the block path when they are longer than the vector,
+    // a whole number of samples is copied without interpolation
+    double fixedDel[] = { del[0], std::ceil(rnd.uniform(1., maxDel * def_sr)) / def_sr, maxDel, 2. * maxDel };
+    for (double d : fixedDel)
+    {
+        std::vector<double> dv(n, d), fv(n, fb[0]), zero(n, 0.);
+        std::string variant = "fixed " + std::to_string(d * def_sr);
+        { Delay u(inFeed, maxDel, d, 0., interp, v); suite.expectUlp(name("Delay", variant, v, interp),
+            Reference::delay(in, dv, zero, maxDel, def_sr, interp), render(u, block, blocks, feeds), 0); }
+        { Delay u(inFeed, maxDel, d, fb[0], interp, v); suite.expectUlp(name("Delay", variant + " feedback", v, interp),
+            Reference::delay(in, dv, fv, maxDel, def_sr, interp), render(u, block, blocks, feeds), 0); }
+        { Delay u(inFeed, maxDel, d, fbFeed, interp, v); suite.expectUlp(name("Delay", variant + " modulated feedback", v, interp),
+            Reference::delay(in, dv, fb, maxDel, def_sr, interp), render(u, block, blocks, feeds), 0); }
+    }
+
+    std::vector<double> fv(n, fb[0]);
+    { Delay u(inFeed, maxDel, delFeed, fb[0], interp, v); suite.expectUlp(name("Delay", "modulated", v, interp),
+        Reference::delay(in, del, fv, maxDel, def_sr, interp), render(u, block, blocks, feeds), 0); }
+    { Delay u(inFeed, maxDel, delFeed, fbFeed, interp, v); suite.expectUlp(name("Delay", "modulated feedback", v, interp),
+        Reference::delay(in, del, fb, maxDel, def_sr, interp), render(u, block, blocks, feeds), 0); }
+}
+
+static void testComb(Suite& suite, Random& rnd, size_t v, bool interp)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    double maxDel = rnd.uniform(0.0005, 0.05);
+    std::vector<double> in = rnd.noise(n);
+    std::vector<double> del = rnd.control(n, 1. / def_sr, maxDel), rt60 = rnd.control(n, 0.05, 3.);
+    Feed inFeed(in, block, v), delFeed(del, block, v), rtFeed(rt60, block, v);
+    std::vector<UGen*> feeds = { &inFeed, &delFeed, &rtFeed };
+    std::vector<double> dv(n, del[0]), rv(n, rt60[0]);
+
+    { Comb u(inFeed, rt60[0], maxDel, del[0], interp, v); suite.expectUlp(name("Comb", "fixed", v, interp),
+        Reference::delay(in, dv, rv, maxDel, def_sr, interp, true), render(u, block, blocks, feeds), 0); }
+    { Comb u(inFeed, rtFeed, maxDel, del[0], interp, v); suite.expectUlp(name("Comb", "modulated rt60", v, interp),
+        Reference::delay(in, dv, rt60, maxDel, def_sr, interp, true), render(u, block, blocks, feeds), 0); }
+    { Comb u(inFeed, rt60[0], maxDel, delFeed, interp, v); suite.expectUlp(name("Comb", "modulated", v, interp),
+        Reference::delay(in, del, rv, maxDel, def_sr, interp, true), render(u, block, blocks, feeds), 0); }
+    { Comb u(inFeed, rtFeed, maxDel, delFeed, interp, v); suite.expectUlp(name("Comb", "modulated both", v, interp),
+        Reference::delay(in, del, rt60, maxDel, def_sr, interp, true), render(u, block, blocks, feeds), 0); }
+}
+
+/** A single tap with feedback is a Delay, whatever vector size it is
+    given: it always takes the writer's.
+*/
+static void testTapSize(Suite& suite, Random& rnd)
+{
+    size_t block, v = 64, blocks = 100;
+    std::vector<double> in = rnd.noise(blocks * v);
+    Feed inFeed(in, block, v);
+    Delay ref(inFeed, 0.05, 0.01, 0.5, true, v);
+    DelayWrite writer(inFeed, 0.05, v);
+    DelayTap tap(writer, 0.01, 0.5, true, 4 * v);
+
+    suite.check("DelayTap vsize of the writer", tap.vsize() == v, std::to_string(tap.vsize()));
+    suite.expectUlp("DelayTap against Delay", render(ref, block, blocks, { &inFeed }),
+        render(tap, block, blocks, { &inFeed, &writer }), 0);
+}
+
+int main()
+{
+    Suite suite("test_delays");
+    Random rnd(31);
+
+    for (size_t v : { 1, 7, 64, 333, 4096 })
+        for (bool interp : { false, true })
+        {
+            testDelay(suite, rnd, v, interp);
+            testComb(suite, rnd, v, interp);
+        }
+    testTapSize(suite, rnd);
+    return suite.finish();
+}
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////
+// test_denormals: decaying tails of the recursive UGens and the
+// flush-to-zero scope
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Denormals.h"
+#include "Butterworth.h"
+#include "Reson.h"
+#include "Tone.h"
+#include "Rms.h"
+#include "IirMulti.h"
+#include "Delay.h"
+#include "Comb.h"
+#include "MultiTap.h"
+#include "FdnReverb.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t v = 64, blocks = (size_t)(6. * def_sr) / v;
+
+/** Check that the tail of a UGen fed an impulse never goes through
+	denormal numbers and ends in exact zeros.
+*/
+static void tail(Suite& suite, const char* name, UGen& u, size_t& block, const std::vector<UGen*>& feeds)
+{
+    std::vector<double> out = render(u, block, blocks, feeds);
+    size_t denormals = 0, lastNonZero = 0;
+    for (size_t i = 0; i < out.size(); i++)
+    {
+        denormals += std::fpclassify(out[i]) == FP_SUBNORMAL;
+        if (out[i] != 0.) lastNonZero = i;
+    }
+    suite.check(std::string(name) + " without denormals", denormals == 0, std::to_string(denormals));
+    suite.check(std::string(name) + " silent", lastNonZero < out.size() - (size_t)def_sr,
+        "(last at " + std::to_string(lastNonZero / def_sr) + " s)");
+}
+
+int main()
+{
+    Suite suite("test_denormals");
+    size_t block;
+    std::vector<double> impulse(blocks * v, 0.);
+    impulse[0] = 1.;
+    Feed in(impulse, block, v);
+    std::vector<UGen*> feeds = { &in };
+
+    { LowP u(in, 3000., v); tail(suite, "LowP", u, block, feeds); }
+    { HighP u(in, 200., v); tail(suite, "HighP", u, block, feeds); }
+    { BandP u(in, 1000., 100., v); tail(suite, "BandP", u, block, feeds); }
+    { Reson u(in, 1000., 50., v); tail(suite, "Reson", u, block, feeds); }
+    { ResonZ u(in, 1000., 50., v); tail(suite, "ResonZ", u, block, feeds); }
+    { ToneLP u(in, 500., v); tail(suite, "ToneLP", u, block, feeds); }
+    { ToneHP u(in, 500., v); tail(suite, "ToneHP", u, block, feeds); }
+    { Rms u(in, 20., v); tail(suite, "Rms", u, block, feeds); }
+    { LowPMulti u({ &in }, 3000., v); tail(suite, "LowPMulti", u, block, feeds); }
+    { Delay u(in, 0.01, 0.01, 0.9, true, v); tail(suite, "Delay", u, block, feeds); }
+    { Comb u(in, 0.5, 0.05, 0.01, true, v); tail(suite, "Comb", u, block, feeds); }
+    { FdnReverb u(in, 0.5, 5000., def_fdn_lines, hadamardMatrix, v); tail(suite, "FdnReverb", u, block, feeds); }
+    {
+        DelayWrite writer(in, 0.05, v);
+        DelayTap u(writer, 0.01, 0.9, true, v);
+        tail(suite, "DelayTap", u, block, { &in, &writer });
+    }
+
+    // The scope flushes denormal results, and restores the mode it found
+    volatile double tiny = 1e-300, scale = 1e-10;
+    bool before = DenormalScope::active();
+    {
+        DenormalScope scope;
+        if (DenormalScope::active())
+            suite.check("DenormalScope flushes", tiny * scale == 0.);
+    }
+    suite.check("DenormalScope restores", DenormalScope::active() == before && tiny * scale != 0.);
+
+    return suite.finish();
+}
@@ -0,0 +1,139 @@
+////////////////////////////////////////////////////////////////////
+// test_fastmath: FastMath approximations against the standard library
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "FastMath.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t points = 200000;
+
+/** Check a scalar approximation against its exact version on random
+    arguments. The error bound is scaled by weight(x) for every argument.
+*/
+template <class Approx, class Exact, class Weight>
+static void bound(Suite& suite, const char* name, Random& rnd, double lo, double hi, double maxErr,
+    Approx approx, Exact exact, Weight weight)
+{
+    double worst = 0., at = 0.;
+    for (size_t i = 0; i < points; i++)
+    {
+        double x = rnd.uniform(lo, hi);
+        double err = std::fabs(approx(x) - exact(x)) / weight(x);
+        if (!(err <= worst)) { worst = err; at = x; }
+    }
+    suite.check(std::string(name) + " error bound", worst <= maxErr,
+        "(" + std::to_string(worst) + " at " + std::to_string(at) + ")");
+}
+
+/** Check a block version against its scalar version.
+*/
+template <class Block, class Scalar>
+static void block(Suite& suite, const char* name, Random& rnd, double lo, double hi, Block blk, Scalar scalar)
+{
+    // An odd length, so that any vector remainder is covered
+    std::vector<double> in(1001), out(in.size()), ref(in.size());
+    for (double& x : in) x = rnd.uniform(lo, hi);
+    blk(in.data(), out.data(), in.size());
+    for (size_t i = 0; i < in.size(); i++) ref[i] = scalar(in[i]);
+    suite.expectUlp(std::string(name) + " block against scalar", ref, out, 0);
+}
+
+int main()
+{
+    Suite suite("test_fastmath");
+    Random rnd(29);
+    auto one = [](double) { return 1.; };
+    auto rel = [](double y) { return std::fabs(y) > min_double ? std::fabs(y) : min_double; };
+
+    // round() and pow2() are exact in their ranges
+    bool exact = true;
+    for (size_t i = 0; i < points; i++)
+    {
+        double x = rnd.uniform(-1e15, 1e15) * (i % 2 ? 1. : 1e-13);
+        exact &= FastMath::round(x) == std::nearbyint(x);
+    }
+    for (int k = -1022; k <= 1023; k++)
+        exact &= FastMath::pow2(k) == std::ldexp(1., k);
+    suite.check("round and pow2 exact", exact);
+
+    bound(suite, "sin", rnd, -1e5, 1e5, 1e-12, [](double x) { return FastMath::sin(x); },
+        [](double x) { return std::sin(x); }, one);
+    bound(suite, "cos", rnd, -1e5, 1e5, 1e-12, [](double x) { return FastMath::cos(x); },
+        [](double x) { return std::cos(x); }, one);
+    bound(suite, "tan", rnd, -1e5, 1e5, 1e-12, [](double x) { return FastMath::tan(x); },
+        [](double x) { return std::tan(x); }, [&](double x) { return rel(std::tan(x)); });
+    bound(suite, "exp", rnd, -708., 709., 1e-12, [](double x) { return FastMath::exp(x); },
+        [](double x) { return std::exp(x); }, [&](double x) { return rel(std::exp(x)); });
+
+    // Logarithm and power on arguments spread over the exponent range
+    bound(suite, "log", rnd, -700., 700., 1e-12, [](double e) { return FastMath::log(std::exp(e)); },
+        [](double e) { return std::log(std::exp(e)); }, [](double e) { return 1. + std::fabs(std::log(std::exp(e))); });
+    double y = 0.37;
+    bound(suite, "pow", rnd, -700., 700., 1e-12, [&](double e) { return FastMath::pow(std::exp(e), y); },
+        [&](double e) { return std::pow(std::exp(e), y); },
+        [&](double e) { return std::pow(std::exp(e), y) * (1. + std::fabs(y * std::log(std::exp(e)))); });
+
+    bound(suite, "acos", rnd, -1., 1., 1e-12, [](double x) { return FastMath::acos(x); },
+        [](double x) { return std::acos(x); }, one);
+    bound(suite, "recip", rnd, -300., 300., 1e-10, [](double e) { return FastMath::recip(std::exp(e)); },
+        [](double e) { return 1. / std::exp(e); }, [](double e) { return 1. / std::exp(e); });
+
+    // atan2 over the whole circle, from the angle of the arguments
+    bound(suite, "atan2", rnd, -pi, pi, 1e-15,
+        [](double a) { return FastMath::atan2(3. * std::sin(a), 3. * std::cos(a)); },
+        [](double a) { return std::atan2(3. * std::sin(a), 3. * std::cos(a)); }, one);
+
+    // Other exponents of the power, within the range of exp, and the documented
+    // edges of the ranges
+    for (double ye : { -3., -1., 0.5, 2., 7.5 })
+        bound(suite, ("pow y " + std::to_string(ye)).c_str(), rnd, -700. / std::fabs(ye), 700. / std::fabs(ye), 1e-12,
+            [&](double e) { return FastMath::pow(std::exp(e), ye); }, [&](double e) { return std::pow(std::exp(e), ye); },
+            [&](double e) { return std::pow(std::exp(e), ye) * (1. + std::fabs(ye * std::log(std::exp(e)))); });
+    bound(suite, "atan2 radius", rnd, -300., 300., 1e-15,
+        [](double e) { return FastMath::atan2(std::exp(e) * 0.6, -std::exp(e) * 0.8); },
+        [](double e) { return std::atan2(std::exp(e) * 0.6, -std::exp(e) * 0.8); }, one);
+    bool edges = FastMath::acos(1.) == 0. && std::fabs(FastMath::acos(-1.) - pi) <= 1e-12 &&
+        std::fabs(FastMath::sin(99999.9) - std::sin(99999.9)) <= 1e-12 &&
+        FastMath::exp(-1000.) == FastMath::exp(-708.) && FastMath::exp(1000.) == FastMath::exp(709.) &&
+        FastMath::pow(-2., 3.) == std::pow(-2., 3.) && FastMath::pow(0., 0.5) == 0.;
+    suite.check("range edges", edges);
+
+    // The precision switch reads back what was set
+    setMathPrecision(fastMath);
+    bool selected = getMathPrecision() == fastMath;
+    setMathPrecision(preciseMath);
+    suite.check("precision switch", selected && getMathPrecision() == preciseMath);
+
+    block(suite, "sin", rnd, -1e3, 1e3, [](const double* i, double* o, size_t n) { FastMath::sin(i, o, n); },
+        [](double x) { return FastMath::sin(x); });
+    block(suite, "cos", rnd, -1e3, 1e3, [](const double* i, double* o, size_t n) { FastMath::cos(i, o, n); },
+        [](double x) { return FastMath::cos(x); });
+    block(suite, "tan", rnd, -1e3, 1e3, [](const double* i, double* o, size_t n) { FastMath::tan(i, o, n); },
+        [](double x) { return FastMath::tan(x); });
+    block(suite, "exp", rnd, -700., 700., [](const double* i, double* o, size_t n) { FastMath::exp(i, o, n); },
+        [](double x) { return FastMath::exp(x); });
+    block(suite, "log", rnd, 1e-300, 1e300, [](const double* i, double* o, size_t n) { FastMath::log(i, o, n); },
+        [](double x) { return FastMath::log(x); });
+    block(suite, "acos", rnd, -1., 1., [](const double* i, double* o, size_t n) { FastMath::acos(i, o, n); },
+        [](double x) { return FastMath::acos(x); });
+    block(suite, "pow", rnd, 1e-3, 1e3, [&](const double* i, double* o, size_t n) { FastMath::pow(i, y, o, n); },
+        [&](double x) { return FastMath::pow(x, y); });
+
+    std::vector<double> ay(1001), ax(ay.size()), aout(ay.size()), aref(ay.size());
+    for (size_t i = 0; i < ay.size(); i++) { ay[i] = rnd.uniform(-2., 2.); ax[i] = rnd.uniform(-2., 2.); }
+    FastMath::atan2(ay.data(), ax.data(), aout.data(), ay.size());
+    for (size_t i = 0; i < ay.size(); i++) aref[i] = FastMath::atan2(ay[i], ax[i]);
+    suite.expectUlp("atan2 block against scalar", aref, aout, 0);
+
+    return suite.finish();
+}
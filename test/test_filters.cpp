@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////
+// test_filters: Iir filters, one-pole filters, Rms and Balance
+// against their scalar references
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <memory>
+#include "TestUtil.h"
+#include "Reference.h"
+#include "FastMath.h"
+#include "Butterworth.h"
+#include "Reson.h"
+#include "Tone.h"
+#include "Rms.h"
+#include "Balance.h"
+#include "IirMulti.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t length = 8000;
+
+/** Error bounds of a UGen: exact with the standard library math,
+    within a few roundings of it with fast math, and within the
+    interpolation error of the coefficient tables when they are used.
+*/
+struct Bounds
+{
+    double fastDb, tableDb;
+};
+
+static std::string name(const char* ugen, const char* variant, size_t v, MathPrecision prec, bool table = false)
+{
+    return std::string(ugen) + " " + variant + " vsize " + std::to_string(v) +
+        (table ? " table" : (prec == fastMath ? " fast" : " precise"));
+}
+
+static void expect(Suite& suite, const std::string& what, const std::vector<double>& ref,
+    const std::vector<double>& out, MathPrecision prec, double fastDb)
+{
+    if (prec == preciseMath) suite.expectUlp(what, ref, out, 0);
+    else suite.expectDb(what, ref, out, fastDb);
+}
+
+/** Test a second order filter with fixed and modulated parameters,
+    and with its coefficient table if it has one.
+*/
+template <class T>
+static void testIir(Suite& suite, Random& rnd, const char* ugen, Reference::Filter f, bool useBand,
+    size_t v, MathPrecision prec, Bounds bounds)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> in = rnd.noise(n);
+    std::vector<double> freq = rnd.control(n, 100., 15000.), band = rnd.control(n, 50., 2000.);
+    std::vector<double> freqFixed(n, freq[0]), bandFixed(n, band[0]);
+    Feed inFeed(in, block, v), freqFeed(freq, block, v), bandFeed(band, block, v);
+    setMathPrecision(prec);
+
+    for (int mod = 0; mod < 2; mod++)
+    {
+        const std::vector<double>& fr = mod ? freq : freqFixed;
+        const std::vector<double>& bw = useBand ? (mod ? band : bandFixed) : bandFixed;
+        std::vector<double> ref = Reference::filter(f, in, fr, bw, def_sr);
+        const char* variant = mod ? "modulated" : "fixed";
+
+        for (int table = 0; table < 2; table++)
+        {
+            if (table && prec == fastMath)
+                continue;
+
+            std::unique_ptr<T> u(mod ? new T(inFeed, freqFeed, bandFeed, v) : new T(inFeed, freq[0], band[0], v));
+            if (table) u->useCoefTable(true);
+            std::vector<double> out = render(*u, block, blocks, { &inFeed, &freqFeed, &bandFeed });
+            if (table) suite.expectDb(name(ugen, variant, v, prec, true), ref, out, bounds.tableDb);
+            else expect(suite, name(ugen, variant, v, prec), ref, out, prec, bounds.fastDb);
+        }
+    }
+    setMathPrecision(preciseMath);
+}
+
+/** Constructors of the filters without bandwidth, with the same
+    signature as the ones with it.
+*/
+template <class T>
+class NoBand : public T
+{
+public:
+    NoBand(UGen& in, double freq, double, size_t vsiz) : T(in, freq, vsiz) { };
+    NoBand(UGen& in, UGen& freq, UGen&, size_t vsiz) : T(in, freq, vsiz) { };
+};
+
+static void testTone(Suite& suite, Random& rnd, size_t v, MathPrecision prec)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> in = rnd.noise(n), comp = rnd.noise(n, 0.1);
+    std::vector<double> freq = rnd.control(n, 1., 15000.), freqFixed(n, freq[0]);
+    Feed inFeed(in, block, v), compFeed(comp, block, v), freqFeed(freq, block, v);
+    std::vector<UGen*> feeds = { &inFeed, &compFeed, &freqFeed };
+    setMathPrecision(prec);
+
+    { ToneLP u(inFeed, freq[0], v); expect(suite, name("ToneLP", "fixed", v, prec),
+        Reference::tone(in, freqFixed, def_sr, false), render(u, block, blocks, feeds), prec, -270.); }
+    { ToneLP u(inFeed, freqFeed, v); expect(suite, name("ToneLP", "modulated", v, prec),
+        Reference::tone(in, freq, def_sr, false), render(u, block, blocks, feeds), prec, -270.); }
+    { ToneHP u(inFeed, freq[0], v); expect(suite, name("ToneHP", "fixed", v, prec),
+        Reference::tone(in, freqFixed, def_sr, true), render(u, block, blocks, feeds), prec, -270.); }
+    { ToneHP u(inFeed, freqFeed, v); expect(suite, name("ToneHP", "modulated", v, prec),
+        Reference::tone(in, freq, def_sr, true), render(u, block, blocks, feeds), prec, -270.); }
+    { Rms u(inFeed, freq[0], v); expect(suite, name("Rms", "fixed", v, prec),
+        Reference::tone(in, freqFixed, def_sr, false, true), render(u, block, blocks, feeds), prec, -270.); }
+    { Rms u(inFeed, freqFeed, v); expect(suite, name("Rms", "modulated", v, prec),
+        Reference::tone(in, freq, def_sr, false, true), render(u, block, blocks, feeds), prec, -270.); }
+
+    // The input starts with silence so that both zero handling modes are exercised
+    std::fill(in.begin(), in.begin() + n / 8, 0.);
+    for (ZeroHandlingMode mode : { addSmallNumber, equalToOne })
+    {
+        const char* variant = mode == equalToOne ? "equalToOne" : "addSmallNumber";
+        { Balance u(inFeed, compFeed, freq[0], mode, v); expect(suite, name("Balance fixed", variant, v, prec),
+            Reference::balance(in, comp, freqFixed, def_sr, mode), render(u, block, blocks, feeds), prec, -190.); }
+        { Balance u(inFeed, compFeed, freqFeed, mode, v); expect(suite, name("Balance modulated", variant, v, prec),
+            Reference::balance(in, comp, freq, def_sr, mode), render(u, block, blocks, feeds), prec, -190.); }
+    }
+
+    // Inputs so small that their RMS estimates are subnormal
+    std::vector<double> tiny(n, 1e-306), tinyComp(n, 2e-306);
+    Feed tinyFeed(tiny, block, v), tinyCompFeed(tinyComp, block, v);
+    for (ZeroHandlingMode mode : { addSmallNumber, equalToOne })
+    {
+        Balance u(tinyFeed, tinyCompFeed, 10., mode, v);
+        std::vector<double> out = render(u, block, blocks, { &tinyFeed, &tinyCompFeed });
+        bool finite = true;
+        for (double x : out) finite = finite && std::isfinite(x) && x >= 0.;
+        suite.check(name("Balance subnormal RMS", mode == equalToOne ? "equalToOne" : "addSmallNumber", v, prec), finite);
+    }
+    setMathPrecision(preciseMath);
+}
+
+static void testOffline(Suite& suite, Random& rnd)
+{
+    // Long enough to be split between several threads
+    size_t n = 200000;
+    std::vector<double> in = rnd.noise(n), out(n);
+    double a[3], b[2], scal;
+    Reference::filterCoefs(Reference::lowPass, 2000., 0., def_sr, a, b, scal);
+
+    size_t block = 0;
+    Feed inFeed(in, block, def_vsize);
+    Iir u(inFeed, a, b);
+    u.processOffline(in.data(), out.data(), n, 4);
+    suite.expectDb("Iir processOffline", Reference::biquad(in, a, b), out, -250.);
+}
+
+static void testMulti(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v, chans = 5;
+    std::vector<std::vector<double>> in(chans);
+    std::vector<std::unique_ptr<Feed>> feeds;
+    std::vector<UGen*> ins;
+    for (size_t c = 0; c < chans; c++)
+    {
+        in[c] = rnd.noise(n);
+        feeds.emplace_back(new Feed(in[c], block, v));
+        ins.push_back(feeds.back().get());
+    }
+
+    double freq = rnd.uniform(100., 15000.);
+    LowPMulti u(ins, freq, v);
+    std::vector<std::vector<double>> out(chans);
+    for (block = 0; block < blocks; block++)
+    {
+        u.process();
+        for (size_t c = 0; c < chans; c++)
+            out[c].insert(out[c].end(), u.channel(c), u.channel(c) + v);
+    }
+
+    std::vector<double> fr(n, freq), bw(n, 0.);
+    for (size_t c = 0; c < chans; c++)
+        suite.expectUlp("LowPMulti channel " + std::to_string(c) + " vsize " + std::to_string(v),
+            Reference::filter(Reference::lowPass, in[c], fr, bw, def_sr), out[c], 0);
+}
+
+int main()
+{
+    Suite suite("test_filters");
+    Random rnd(2024);
+
+    for (size_t v : { 1, 7, 64, 333 })
+        for (MathPrecision prec : { preciseMath, fastMath })
+        {
+            testIir<NoBand<LowP>>(suite, rnd, "LowP", Reference::lowPass, false, v, prec, { -230., -50. });
+            testIir<NoBand<HighP>>(suite, rnd, "HighP", Reference::highPass, false, v, prec, { -230., -50. });
+            testIir<BandP>(suite, rnd, "BandP", Reference::bandPass, true, v, prec, { -230., -55. });
+            testIir<BandR>(suite, rnd, "BandR", Reference::bandReject, true, v, prec, { -230., -55. });
+            testIir<ResonR>(suite, rnd, "ResonR", Reference::resonR, true, v, prec, { -230., -36. });
+            testIir<ResonZ>(suite, rnd, "ResonZ", Reference::resonZ, true, v, prec, { -230., -55. });
+            testIir<Reson>(suite, rnd, "Reson", Reference::reson, true, v, prec, { -230., -36. });
+            testTone(suite, rnd, v, prec);
+        }
+    for (size_t v : { 1, 64 })
+        testMulti(suite, rnd, v);
+    testOffline(suite, rnd);
+
+    return suite.finish();
+}
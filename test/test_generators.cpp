@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////
+// test_generators: Phasor, table readers, oscillators and envelopes
+// against their scalar references
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include "TestUtil.h"
+#include "Reference.h"
+#include "Phasor.h"
+#include "TableRead.h"
+#include "Osc.h"
+#include "SegmentEnv.h"
+#include "FastMath.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t length = 6000;
+
+static std::string name(const char* ugen, const char* variant, size_t v)
+{
+    return std::string(ugen) + " " + variant + " vsize " + std::to_string(v);
+}
+
+static void testPhasor(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    double ph = rnd.uniform();
+    std::vector<double> fr = rnd.control(n, -3000., 8000.);
+    Feed frFeed(fr, block, v);
+
+    { Phasor u(fr[0], ph, v); suite.expectUlp(name("Phasor", "fixed", v),
+        Reference::phasor(std::vector<double>(n, fr[0]), ph, def_sr), render(u, block, blocks), 0); }
+    { Phasor u(frFeed, ph, v); suite.expectUlp(name("Phasor", "modulated", v),
+        Reference::phasor(fr, ph, def_sr), render(u, block, blocks, { &frFeed }), 0); }
+
+    // Resets scheduled ahead, at most as many as the event queue holds
+    std::vector<std::pair<size_t, double>> resets;
+    for (size_t k = 0; k < def_event_capacity; k++)
+        resets.push_back(std::make_pair(rnd.integer(0, n - 1), rnd.uniform(-2., 2.)));
+    std::sort(resets.begin(), resets.end(),
+        [](const std::pair<size_t, double>& a, const std::pair<size_t, double>& b) { return a.first < b.first; });
+    Phasor u(frFeed, ph, v);
+    for (const std::pair<size_t, double>& r : resets) u.resetAt(r.first, r.second);
+    suite.expectUlp(name("Phasor", "resets", v), Reference::phasor(fr, ph, def_sr, resets),
+        render(u, block, blocks, { &frFeed }), 0);
+}
+
+static void testTableRead(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> tabData = rnd.noise(rnd.integer(16, 5000));
+    FuncTab tab(tabData);
+
+    for (int norm = 0; norm < 2; norm++)
+        for (int wrap = 0; wrap < 2; wrap++)
+        {
+            // Indices reach past both ends of the table
+            double range = norm ? 1. : (double)tab.size();
+            std::vector<double> index = rnd.control(n, -1.5 * range, 2.5 * range, 8);
+            double fixed = index[0];
+            Feed indFeed(index, block, v);
+            std::string variant = std::string(norm ? "norm" : "raw") + (wrap ? " wrap" : " clamp");
+            std::vector<double> fixedIndex(n, fixed);
+
+            { TableRead u(fixed, tab, norm == 1, wrap == 1, v); suite.expectUlp(name("TableRead", variant.c_str(), v),
+                Reference::tableRead(fixedIndex, tabData, norm == 1, wrap == 1, 0), render(u, block, blocks), 0); }
+            { TableRead u(indFeed, tab, norm == 1, wrap == 1, v); suite.expectUlp(name("TableRead", variant.c_str(), v),
+                Reference::tableRead(index, tabData, norm == 1, wrap == 1, 0), render(u, block, blocks, { &indFeed }), 0); }
+            { TableReadI u(fixed, tab, norm == 1, wrap == 1, v); suite.expectUlp(name("TableReadI", variant.c_str(), v),
+                Reference::tableRead(fixedIndex, tabData, norm == 1, wrap == 1, 1), render(u, block, blocks), 0); }
+            { TableReadI u(indFeed, tab, norm == 1, wrap == 1, v); suite.expectUlp(name("TableReadI", variant.c_str(), v),
+                Reference::tableRead(index, tabData, norm == 1, wrap == 1, 1), render(u, block, blocks, { &indFeed }), 0); }
+
+            // The cubic polynomial is factored differently from the reference
+            { TableReadC u(fixed, tab, norm == 1, wrap == 1, v); suite.expectDb(name("TableReadC", variant.c_str(), v),
+                Reference::tableRead(fixedIndex, tabData, norm == 1, wrap == 1, 3), render(u, block, blocks), -280.); }
+            { TableReadC u(indFeed, tab, norm == 1, wrap == 1, v); suite.expectDb(name("TableReadC", variant.c_str(), v),
+                Reference::tableRead(index, tabData, norm == 1, wrap == 1, 3), render(u, block, blocks, { &indFeed }), -280.); }
+        }
+}
+
+static void testOsc(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> tabData = rnd.noise(rnd.integer(64, 4096));
+    FuncTab tab(tabData);
+    std::vector<double> amp = rnd.control(n, -1., 1.), fr = rnd.control(n, 20., 15000.);
+    Feed ampFeed(amp, block, v), frFeed(fr, block, v);
+    double ph = rnd.uniform(), dco = rnd.uniform(-1., 1.);
+    std::vector<double> ampFixed(n, amp[0]), frFixed(n, fr[0]);
+
+    { Osc u(amp[0], fr[0], tab, ph, dco, v); suite.expectUlp(name("Osc", "fixed", v),
+        Reference::osc(ampFixed, frFixed, tabData, ph, dco, def_sr, 0), render(u, block, blocks), 0); }
+    { Osc u(ampFeed, frFeed, tab, ph, dco, v); suite.expectUlp(name("Osc", "modulated", v),
+        Reference::osc(amp, fr, tabData, ph, dco, def_sr, 0), render(u, block, blocks, { &ampFeed, &frFeed }), 0); }
+    { OscI u(amp[0], fr[0], tab, ph, dco, v); suite.expectUlp(name("OscI", "fixed", v),
+        Reference::osc(ampFixed, frFixed, tabData, ph, dco, def_sr, 1), render(u, block, blocks), 0); }
+    { OscI u(ampFeed, frFeed, tab, ph, dco, v); suite.expectUlp(name("OscI", "modulated", v),
+        Reference::osc(amp, fr, tabData, ph, dco, def_sr, 1), render(u, block, blocks, { &ampFeed, &frFeed }), 0); }
+    { OscC u(amp[0], fr[0], tab, ph, dco, v); suite.expectDb(name("OscC", "fixed", v),
+        Reference::osc(ampFixed, frFixed, tabData, ph, dco, def_sr, 3), render(u, block, blocks), -280.); }
+    { OscC u(ampFeed, frFeed, tab, ph, dco, v); suite.expectDb(name("OscC", "modulated", v),
+        Reference::osc(amp, fr, tabData, ph, dco, def_sr, 3), render(u, block, blocks, { &ampFeed, &frFeed }), -280.); }
+}
+
+static void testSegmentEnv(Suite& suite, Random& rnd, size_t v, MathPrecision prec)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    const char* precName = prec == fastMath ? "fast" : "precise";
+    setMathPrecision(prec);
+
+    for (int c = 0; c < 3; c++)
+    {
+        // Linear, exponential and mixed segments, some of them with zero
+        // levels, of lengths from under a sample to longer than the test
+        size_t segs = rnd.integer(1, 5);
+        std::vector<double> levels, times;
+        std::vector<Curve> curves;
+        for (size_t k = 0; k <= segs; k++)
+            levels.push_back(k % 3 == 2 && c != 1 ? 0. : rnd.uniform(0.05, 2.) * (rnd.uniform() < 0.2 ? -1. : 1.));
+        for (size_t k = 0; k < segs; k++)
+        {
+            times.push_back(std::exp(rnd.uniform(std::log(0.5 / def_sr), std::log(2. * length / def_sr))));
+            curves.push_back(c == 0 ? linear : (c == 1 ? exponential : (rnd.uniform() < 0.5 ? linear : exponential)));
+        }
+        if (c != 0)
+            for (size_t k = 1; k < levels.size(); k++) levels[k] = std::fabs(levels[k]) * (levels[0] < 0. ? -1. : 1.);
+        bool releaseSeg = segs > 1 && rnd.uniform() < 0.5;
+        double offset = rnd.uniform(-1., 1.);
+
+        std::vector<std::pair<size_t, EventType>> events;
+        for (size_t k = 0; k < 8; k++)
+            events.push_back(std::make_pair(rnd.integer(0, n - 1), k % 2 ? releaseEvent : retrigEvent));
+        std::sort(events.begin(), events.end(),
+            [](const std::pair<size_t, EventType>& a, const std::pair<size_t, EventType>& b) { return a.first < b.first; });
+
+        SegmentEnv u(levels, times, curves, offset, releaseSeg, v);
+        for (const std::pair<size_t, EventType>& e : events)
+            e.second == retrigEvent ? u.scheduleRetrig(e.first) : u.scheduleRelease(e.first);
+
+        // The envelope is generated in closed form, the reference by accumulation
+        const char* variant[] = { "linear", "exponential", "mixed" };
+        suite.expectDb(name("SegmentEnv", variant[c], v) + " " + precName,
+            Reference::segmentEnv(levels, times, curves, offset, releaseSeg, def_sr, n, events),
+            render(u, block, blocks), -220.);
+    }
+    setMathPrecision(preciseMath);
+}
+
+int main()
+{
+    Suite suite("test_generators");
+    Random rnd(45);
+
+    // The dB bounds catch NaN and infinite output, and pass exact matches
+    std::vector<double> sig = rnd.noise(64), nans(64, NAN), infs(64, INFINITY);
+    suite.check("errorDb rejects NaN", !(errorDb(sig, nans) <= -100.) && !(errorDb(sig, { sig[0], NAN }) <= 0.));
+    suite.check("errorDb rejects inf", !(errorDb(sig, infs) <= -100.));
+    suite.check("errorDb passes exact", errorDb(sig, sig) <= -300.);
+
+    for (size_t v : { 1, 7, 64, 333 })
+    {
+        testPhasor(suite, rnd, v);
+        testTableRead(suite, rnd, v);
+        testOsc(suite, rnd, v);
+        testSegmentEnv(suite, rnd, v, preciseMath);
+        testSegmentEnv(suite, rnd, v, fastMath);
+    }
+    return suite.finish();
+}
@@ -0,0 +1,63 @@
+////////////////////////////////////////////////////////////////////
+// test_profile: counters of the profiling build
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "FuncTab.h"
+#include "Osc.h"
+#include "Butterworth.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+int main()
+{
+    Suite suite("test_profile");
+#ifdef KIWIWAVES_PROFILE
+    size_t v = 64, blocks = 500;
+    std::vector<double> saw(1024);
+    for (size_t k = 0; k < saw.size(); k++) saw[k] = 2. * k / saw.size() - 1.;
+    FuncTab tab(saw);
+
+    // Two filters pulling their oscillators, as in a patch
+    OscI osc1(0.5, 110., tab, 0., 0., v), osc2(0.5, 220., tab, 0., 0., v);
+    LowP lp1(osc1, 2000., v), lp2(osc2, 3000., v);
+    uint64_t start = Profile::ticks();
+    for (size_t b = 0; b < blocks; b++)
+    {
+        lp1.process();
+        lp2.process();
+    }
+    uint64_t elapsed = Profile::ticks() - start;
+
+    for (const UGen* u : { (const UGen*)&osc1, (const UGen*)&osc2, (const UGen*)&lp1, (const UGen*)&lp2 })
+    {
+        suite.check("calls", u->profile().calls == blocks, std::to_string(u->profile().calls));
+        suite.check("samples", u->profile().samples == blocks * v, std::to_string(u->profile().samples));
+        suite.check("max ticks", u->profile().maxTicks <= u->profile().ticks);
+    }
+
+    // The filters are not charged for their inputs
+    Profile::Report rep = Profile::report({ &osc1, &osc2, &lp1, &lp2 });
+    suite.check("ticks within the elapsed time", rep.ticks <= elapsed,
+        std::to_string(rep.ticks) + " of " + std::to_string(elapsed));
+    suite.check("seconds", std::fabs(rep.seconds - blocks * v / def_sr) < 1e-12, std::to_string(rep.seconds));
+    double share = 0.;
+    for (const Profile::Entry& e : rep.ugens) share += e.share;
+    suite.check("shares add to one", std::fabs(share - 1.) < 1e-12, std::to_string(share));
+    suite.check("types", rep.types.size() == 2 && rep.types[0].instances == 2 && rep.types[1].instances == 2);
+    for (const Profile::Entry& e : rep.types)
+        suite.check("type names", e.name == "OscI" || e.name == "LowP", e.name);
+
+    Profile::reset({ &osc1, &osc2, &lp1, &lp2 });
+    suite.check("reset", osc1.profile().calls == 0 && lp2.profile().ticks == 0);
+#endif
+    return suite.finish();
+}
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////
+// test_resampling: HalfBand, Oversampler and Resampler against
+// ideal delayed and resampled sines
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Oversampler.h"
+#include "Resampler.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t length = 8192;
+
+/** Sine of frequency w in radians per sample, delayed by lat samples.
+*/
+static std::vector<double> sine(size_t n, double w, double lat = 0.)
+{
+    std::vector<double> out(n);
+    for (size_t i = 0; i < n; i++) out[i] = std::sin(w * (i - lat));
+    return out;
+}
+
+/** Drop the first skip samples, the start-up transient of the filters.
+*/
+static std::vector<double> tail(const std::vector<double>& x, size_t skip)
+{
+    return std::vector<double>(x.begin() + skip, x.end());
+}
+
+/** Interpolate and decimate sines in the passband of a HalfBand, the
+    images left by the interpolation are checked against a sine fit.
+    The stages with fewer taps run at the higher rates of an Oversampler.
+*/
+static void testHalfBand(Suite& suite, size_t taps, double sr, size_t block, double bound, double imageBound)
+{
+    for (double f : { 100., 5000., 12000., 18000. })
+    {
+        std::string what = "HalfBand taps " + std::to_string(taps) + " block " + std::to_string(block) +
+            " freq " + std::to_string((int)f);
+        double w = twopi * f / sr;
+        HalfBand hb(taps, block);
+        std::vector<double> in = sine(length, w), up(2 * length), down(length);
+        for (size_t k = 0; k < length; k += block)
+            hb.up(in.data() + k, up.data() + 2 * k);
+        hb.reset();
+        for (size_t k = 0; k < length; k += block)
+            hb.down(up.data() + 2 * k, down.data() + k);
+
+        size_t skip = 2 * hb.latency();
+        std::vector<double> upTail = tail(up, skip), downTail = tail(down, skip);
+        suite.expectDb(what + " up", tail(sine(2 * length, w / 2., (double)hb.latency()), skip), upTail, bound);
+        suite.expectDb(what + " up images", sineFit(upTail, w / 2.), upTail, imageBound);
+        suite.expectDb(what + " up down", tail(sine(length, w, (double)hb.latency()), skip), downTail, bound);
+    }
+}
+
+/** An Oversampler with no children gives its input delayed by latency().
+*/
+static void testOversampler(Suite& suite, size_t factor, size_t v, double bound)
+{
+    size_t block, blocks = length / v + 1, n = blocks * v;
+    for (double f : { 100., 5000., 12000., 18000. })
+    {
+        double w = twopi * f / def_sr;
+        std::vector<double> in = sine(n, w);
+        Feed inFeed(in, block, v);
+        Oversampler u(inFeed, factor, v);
+        std::vector<double> out = render(u, block, blocks, { &inFeed });
+
+        size_t skip = (size_t)u.latency() * 2;
+        suite.expectDb("Oversampler factor " + std::to_string(factor) + " vsize " + std::to_string(v) +
+            " freq " + std::to_string((int)f), tail(sine(n, w, u.latency()), skip), tail(out, skip), bound);
+    }
+}
+
+/** Convert sines between sampling rates, they have to keep their
+    frequency in Hz with no delay. The 17 kHz sine is in the rolloff of
+    the filter when downsampling, so its gain is only checked loosely and
+    the error left after a sine fit is checked separately.
+*/
+static void testResampler(Suite& suite, double srIn, double srOut, size_t v)
+{
+    size_t block, blocks = length / v + 1, n = blocks * v;
+    std::string rates = std::to_string((int)srIn) + " to " + std::to_string((int)srOut);
+    for (double f : { 1000., 10000., 17000. })
+    {
+        std::vector<double> in = sine((size_t)(n * srIn / srOut) + 1024, twopi * f / srIn);
+        Stream stream(in, 100, srIn);
+        Resampler u(stream, 1., v, srOut);
+        std::vector<double> out = render(u, block, blocks);
+
+        double w = twopi * f / srOut;
+        size_t skip = (size_t)(2 * def_resamp_zeros * srOut / srIn);
+        std::string what = "Resampler " + rates + " freq " + std::to_string((int)f) + " vsize " + std::to_string(v);
+        suite.expectDb(what, tail(sine(n, w), skip), tail(out, skip), f > 15000. ? -40. : -90.);
+        suite.expectDb(what + " residual", sineFit(tail(out, skip), w), tail(out, skip), -97.);
+    }
+
+    // A sine between the output and input Nyquist frequencies is filtered out
+    if (srOut < 60000. && srIn > 60000.)
+    {
+        std::vector<double> in = sine((size_t)(n * srIn / srOut) + 1024, twopi * 30000. / srIn);
+        Stream stream(in, 100, srIn);
+        Resampler u(stream, 1., v, srOut);
+        std::vector<double> out = render(u, block, blocks);
+        size_t skip = 2 * def_resamp_zeros;
+        suite.expectDb("Resampler " + rates + " freq 30000 rejected vsize " + std::to_string(v),
+            std::vector<double>(n - skip, 0.), tail(out, skip), -95.);
+    }
+}
+
+int main()
+{
+    Suite suite("test_resampling");
+
+    for (size_t block : { 1, 64 })
+    {
+        testHalfBand(suite, 24, 44100., block, -85., -90.);
+        testHalfBand(suite, 8, 88200., block, -83., -89.);
+        testHalfBand(suite, 6, 176400., block, -77., -83.);
+    }
+    for (size_t v : { 1, 64, 333 })
+    {
+        testOversampler(suite, 2, v, -85.);
+        testOversampler(suite, 4, v, -79.);
+        testOversampler(suite, 8, v, -72.);
+        testResampler(suite, 48000., 44100., v);
+        testResampler(suite, 44100., 96000., v);
+        testResampler(suite, 96000., 44100., v);
+    }
+
+    return suite.finish();
+}
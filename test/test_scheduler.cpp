@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////
+// test_scheduler: dispatch of more events than a target can hold
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Scheduler.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+/** Schedule events events of one ControlSig in the first vector, and
+	check that every one of them gets dispatched, in order.
+*/
+static void testOverflow(Suite& suite, size_t v, size_t events)
+{
+    std::string what = std::to_string(events) + " events vsize " + std::to_string(v);
+    Scheduler sched(2 * events, v);
+    ControlSig sig(-1., v), other(-1., v);
+    size_t step = v / events > 0 ? v / events : 1;
+
+    for (size_t k = 0; k < events; k++)
+        sched.setAt(k * step % v, sig, (double)k);
+    sched.setAt(v - 1, other, 1.);
+
+    std::vector<double> out;
+    double dispatched = 0.;
+    bool otherOnTime = false;
+    for (size_t block = 0; block < events / def_event_capacity + 2; block++)
+    {
+        const double* count = sched.process();
+        for (size_t i = 0; i < v; i++) dispatched += count[i];
+        const double* s = sig.process();
+        out.insert(out.end(), s, s + v);
+        if (block == 0) otherOnTime = other.process()[v - 1] == 1.;
+    }
+
+    // The values a target could take land on their samples, the others
+    // follow from the next vector on, and the signal never goes back
+    bool ordered = true;
+    for (size_t i = 1; i < out.size(); i++) ordered = ordered && out[i] >= out[i - 1];
+    bool onTime = true;
+    for (size_t k = 0; k < events && k < def_event_capacity; k++)
+        onTime = onTime && out[k * step % v] == (double)k;
+
+    suite.check(what + " dispatched", dispatched == (double)(events + 1), std::to_string(dispatched));
+    suite.check(what + " none pending", sched.pending() == 0, std::to_string(sched.pending()));
+    suite.check(what + " last value", out.back() == (double)(events - 1), std::to_string(out.back()));
+    suite.check(what + " in order", ordered);
+    suite.check(what + " first ones on time", onTime);
+    suite.check(what + " other target on time", otherOnTime);
+    suite.check(what + " deferred", (sched.deferred() > 0) == (events > def_event_capacity),
+        std::to_string(sched.deferred()));
+}
+
+int main()
+{
+    Suite suite("test_scheduler");
+
+    testOverflow(suite, 64, def_event_capacity);
+    testOverflow(suite, 256, def_event_capacity + 1);
+    testOverflow(suite, 256, 100);
+    testOverflow(suite, 1024, 300);
+
+    return suite.finish();
+}
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////
+// test_spectral: Fft, Convolver, Stft, PhaseVocoder and the meters
+// against their direct scalar references
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Reference.h"
+#include "Fft.h"
+#include "Convolver.h"
+#include "Stft.h"
+#include "PhaseVocoder.h"
+#include "Meters.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static void testFft(Suite& suite, Random& rnd)
+{
+    for (size_t n = 4; n <= 4096; n *= 2)
+    {
+        Fft fft(n);
+        std::vector<double> in = rnd.noise(n), re(n / 2 + 1), im(n / 2 + 1), back(n);
+        std::vector<double> refRe, refIm;
+        fft.forward(in.data(), re.data(), im.data());
+        Reference::dft(in, refRe, refIm);
+
+        // Both parts against the peak of the spectrum
+        std::vector<double> ref(refRe), out(re);
+        ref.insert(ref.end(), refIm.begin(), refIm.end());
+        out.insert(out.end(), im.begin(), im.end());
+        suite.expectDb("Fft forward size " + std::to_string(n), ref, out, -270.);
+
+        fft.inverse(re.data(), im.data(), back.data());
+        suite.expectDb("Fft inverse size " + std::to_string(n), in, back, -280.);
+    }
+}
+
+static void testConvolver(Suite& suite, Random& rnd, size_t v)
+{
+    size_t length = 12000, block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> in = rnd.noise(n);
+    Feed inFeed(in, block, v);
+
+    for (size_t irLen : { 1, 100, 256, 2000 })
+        for (bool zeroLat : { false, true })
+        {
+            // Decaying noise, as a room response
+            std::vector<double> ir = rnd.noise(irLen);
+            for (size_t k = 0; k < irLen; k++) ir[k] *= std::exp(-5. * k / irLen);
+            FuncTab tab(ir);
+
+            Convolver u(inFeed, tab, 0, zeroLat, def_conv_bsize, v);
+            suite.expectDb("Convolver ir " + std::to_string(irLen) + (zeroLat ? " zero latency" : "") +
+                " vsize " + std::to_string(v), Reference::convolve(in, ir, u.latency()),
+                render(u, block, blocks, { &inFeed }), -250.);
+        }
+}
+
+/** Without processing, an Stft gives its input delayed by latency().
+*/
+static void testStft(Suite& suite, Random& rnd, size_t v)
+{
+    size_t length = 12000, block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> in = rnd.noise(n);
+    Feed inFeed(in, block, v);
+
+    for (size_t fftSiz : { 256, 1024 })
+        for (size_t hop : { fftSiz / 4, fftSiz / 8 })
+        {
+            Stft u(inFeed, fftSiz, hop, v);
+            suite.expectDb("Stft size " + std::to_string(fftSiz) + " hop " + std::to_string(hop) +
+                " vsize " + std::to_string(v), Reference::convolve(in, { 1. }, u.latency()),
+                render(u, block, blocks, { &inFeed }), -280.);
+        }
+}
+
+/** A PhaseVocoder playing a sine has to give a sine at the shifted
+    frequency. The error left after a sine fit is near rounding with no
+    stretch or shift, and grows with the phase and bin changes they make.
+*/
+static void testPhaseVocoder(Suite& suite, size_t v)
+{
+    size_t length = 24000, block, blocks = length / v;
+    double f = 1000.;
+    std::vector<double> src(2 * length);
+    for (size_t i = 0; i < src.size(); i++) src[i] = std::sin(twopi * f * i / def_sr);
+    FuncTab tab(src);
+
+    for (double stretch : { 1., 1.5 })
+        for (double pitch : { 1., 0.75, 1.25 })
+        {
+            PhaseVocoder u(tab, stretch, pitch, def_fft_size, def_hop_size, v);
+            std::vector<double> out = render(u, block, blocks);
+            out.erase(out.begin(), out.begin() + 2 * def_fft_size);
+            double bound = pitch != 1. ? -50. : (stretch != 1. ? -95. : -230.);
+            suite.expectDb("PhaseVocoder stretch " + std::to_string(stretch) + " pitch " + std::to_string(pitch) +
+                " vsize " + std::to_string(v), sineFit(out, twopi * f * pitch / def_sr), out, bound);
+        }
+}
+
+static void testMeters(Suite& suite, Random& rnd, size_t v)
+{
+    size_t length = 20000, block, blocks = (length + v - 1) / v, n = blocks * v;
+
+    // Bursts of noise, so the readings rise and fall
+    std::vector<double> in = rnd.noise(n), amp = rnd.control(n, 0., 1., 2000);
+    for (size_t i = 0; i < n; i++) in[i] *= amp[i];
+    Feed inFeed(in, block, v);
+
+    for (double win : { 1. / def_sr, 0.001, 0.01 })
+        for (size_t decim : { 1, 3, 64 })
+        {
+            std::string variant = " window " + std::to_string(win) + " decim " + std::to_string(decim) +
+                " vsize " + std::to_string(v);
+            RmsMeter rms(inFeed, win, decim, v);
+            PeakMeter peak(inFeed, win, decim, v);
+            std::vector<double> rmsOut, peakOut;
+            for (block = 0; block < blocks; block++)
+            {
+                inFeed.process();
+                const double* r = rms.process();
+                const double* p = peak.process();
+                rmsOut.insert(rmsOut.end(), r, r + rms.vsize());
+                peakOut.insert(peakOut.end(), p, p + peak.vsize());
+            }
+
+            // The running sum is recomputed every window, so its error stays bounded,
+            // but near silence the square root raises it to about sqrt(eps)
+            suite.expectDb("RmsMeter" + variant, Reference::meter(in, rms.windowSize(), decim, v, false), rmsOut, -140.);
+            suite.expectUlp("PeakMeter" + variant, Reference::meter(in, peak.windowSize(), decim, v, true), peakOut, 0);
+        }
+}
+
+/** Meters given a vector size that does not match their input's:
+	only the frames they have readings for are measured.
+*/
+static void testMeterSizes(Suite& suite, Random& rnd)
+{
+    size_t block, blocks = 40, v = 256, m = 64;
+    std::vector<double> in = rnd.noise(blocks * v), head;
+    for (size_t b = 0; b < blocks; b++) head.insert(head.end(), in.begin() + b * v, in.begin() + b * v + m);
+    Feed inFeed(in, block, v), headFeed(head, block, m);
+
+    PeakMeter shorter(inFeed, 0.001, 1, m), longer(headFeed, 0.001, 1, v);
+    std::vector<double> ref = Reference::meter(head, shorter.windowSize(), 1, m, true);
+    suite.expectUlp("PeakMeter vsize 64 on 256 frames", ref, render(shorter, block, blocks, { &inFeed }), 0);
+
+    std::vector<double> out = render(longer, block, blocks, { &headFeed }), held;
+    for (size_t b = 0; b < blocks; b++)
+    {
+        held.insert(held.end(), ref.begin() + b * m, ref.begin() + (b + 1) * m);
+        held.insert(held.end(), v - m, ref[(b + 1) * m - 1]);
+    }
+    suite.expectUlp("PeakMeter vsize 256 on 64 frames", held, out, 0);
+    suite.check("PeakMeter vsize 256 on 64 frames value", longer.value() == ref.back());
+}
+
+int main()
+{
+    Suite suite("test_spectral");
+    Random rnd(34);
+
+    testFft(suite, rnd);
+    testMeterSizes(suite, rnd);
+    for (size_t v : { 1, 64, 333, 1024 })
+    {
+        testConvolver(suite, rnd, v);
+        testStft(suite, rnd, v);
+        testPhaseVocoder(suite, v);
+        testMeters(suite, rnd, v);
+    }
+    return suite.finish();
+}
@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////
+// test_static: static chains against the dynamic UGens they mirror
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include "TestUtil.h"
+#include "Static.h"
+#include "Phasor.h"
+#include "TableRead.h"
+#include "Osc.h"
+#include "ExternalUGen.h"
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+static const size_t length = 6000;
+
+static std::string name(const char* chain, const char* variant, size_t v)
+{
+    return std::string(chain) + " " + variant + " vsize " + std::to_string(v);
+}
+
+static void testGenerators(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v;
+    std::vector<double> tabData = rnd.noise(rnd.integer(64, 4096));
+    FuncTab tab(tabData);
+    std::vector<double> amp = rnd.control(blocks * v, -1., 1.), fr = rnd.control(blocks * v, 20., 15000.);
+    std::vector<double> index = rnd.control(blocks * v, -1.5, 2.5);
+    Feed ampFeed(amp, block, v), frFeed(fr, block, v), indFeed(index, block, v);
+    std::vector<UGen*> feeds = { &ampFeed, &frFeed, &indFeed };
+    double ph = rnd.uniform(), dco = rnd.uniform(-1., 1.);
+
+    {
+        KiwiWaves::Phasor ref(frFeed, ph, v);
+        Static::Pipeline<Static::Phasor<Static::In>> u(Static::phasor(frFeed, ph), v);
+        suite.expectUlp(name("Phasor", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0);
+    }
+    for (int wrap = 0; wrap < 2; wrap++)
+    {
+        const char* variant = wrap ? "wrap" : "clamp";
+        { KiwiWaves::TableRead ref(indFeed, tab, true, wrap == 1, v);
+            Static::Pipeline<Static::TableRead<Static::In>> u(Static::tableRead(indFeed, tab, true, wrap == 1), v);
+            suite.expectUlp(name("TableRead", variant, v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+        { KiwiWaves::TableReadI ref(indFeed, tab, true, wrap == 1, v);
+            Static::Pipeline<Static::TableReadI<Static::In>> u(Static::tableReadI(indFeed, tab, true, wrap == 1), v);
+            suite.expectUlp(name("TableReadI", variant, v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+        { KiwiWaves::TableReadC ref(indFeed, tab, true, wrap == 1, v);
+            Static::Pipeline<Static::TableReadC<Static::In>> u(Static::tableReadC(indFeed, tab, true, wrap == 1), v);
+            suite.expectUlp(name("TableReadC", variant, v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    }
+
+    { KiwiWaves::Osc ref(amp[0], fr[0], tab, ph, dco, v);
+        auto u = Static::pipeline(Static::osc(amp[0], fr[0], tab, ph, dco), v);
+        suite.expectUlp(name("Osc", "fixed", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::OscI ref(ampFeed, frFeed, tab, ph, dco, v);
+        auto u = Static::pipeline(Static::oscI(ampFeed, frFeed, tab, ph, dco), v);
+        suite.expectUlp(name("OscI", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::OscC ref(ampFeed, fr[0], tab, ph, dco, v);
+        auto u = Static::pipeline(Static::oscC(ampFeed, fr[0], tab, ph, dco), v);
+        suite.expectUlp(name("OscC", "modulated amp", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+}
+
+static void testFilters(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> in = rnd.noise(n), freq = rnd.control(n, 100., 15000.), band = rnd.control(n, 50., 2000.);
+    Feed inFeed(in, block, v), freqFeed(freq, block, v), bandFeed(band, block, v);
+    std::vector<UGen*> feeds = { &inFeed, &freqFeed, &bandFeed };
+
+    { KiwiWaves::LowP ref(inFeed, freq[0], v); auto u = Static::pipeline(Static::lowP(inFeed, freq[0]), v);
+        suite.expectUlp(name("LowP", "fixed", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::LowP ref(inFeed, freqFeed, v); auto u = Static::pipeline(Static::lowP(inFeed, freqFeed), v);
+        suite.expectUlp(name("LowP", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::HighP ref(inFeed, freqFeed, v); auto u = Static::pipeline(Static::highP(inFeed, freqFeed), v);
+        suite.expectUlp(name("HighP", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::BandP ref(inFeed, freqFeed, bandFeed, v); auto u = Static::pipeline(Static::bandP(inFeed, freqFeed, bandFeed), v);
+        suite.expectUlp(name("BandP", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::BandR ref(inFeed, freq[0], bandFeed, v); auto u = Static::pipeline(Static::bandR(inFeed, freq[0], bandFeed), v);
+        suite.expectUlp(name("BandR", "modulated band", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::ToneLP ref(inFeed, freqFeed, v); auto u = Static::pipeline(Static::toneLP(inFeed, freqFeed), v);
+        suite.expectUlp(name("ToneLP", "modulated", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+    { KiwiWaves::ToneHP ref(inFeed, freq[0], v); auto u = Static::pipeline(Static::toneHP(inFeed, freq[0]), v);
+        suite.expectUlp(name("ToneHP", "fixed", v), render(ref, block, blocks, feeds), render(u, block, blocks, feeds), 0); }
+}
+
+static void testChain(Suite& suite, Random& rnd, size_t v)
+{
+    size_t block, blocks = (length + v - 1) / v, n = blocks * v;
+    std::vector<double> tabData = rnd.noise(1024);
+    FuncTab tab(tabData);
+    std::vector<double> env = rnd.control(n, 0., 1.), cut = rnd.control(n, 200., 8000.);
+    Feed envFeed(env, block, v), cutFeed(cut, block, v);
+    std::vector<UGen*> feeds = { &envFeed, &cutFeed };
+
+    // Two detuned oscillators, scaled by an envelope into a modulated low-pass
+    KiwiWaves::OscI osc1(0.5, 220., tab, 0., 0., v), osc2(0.5, 221.5, tab, 0.25, 0., v);
+    KiwiWaves::ExternalUGen mix(v);
+    KiwiWaves::LowP ref(mix, cutFeed, v);
+    std::vector<double> refOut;
+    for (block = 0; block < blocks; block++)
+    {
+        for (UGen* f : feeds) f->process();
+        osc1.process();
+        osc2.process();
+        mix.setData(0.);
+        mix += osc1;
+        mix += osc2;
+        mix *= envFeed;
+        const double* y = ref.process();
+        refOut.insert(refOut.end(), y, y + v);
+    }
+
+    auto voice = Static::lowP((Static::oscI(0.5, 220., tab) + Static::oscI(0.5, 221.5, tab, 0.25)) *
+        Static::in(envFeed), cutFeed);
+    Static::Pipeline<decltype(voice)> u(voice, v);
+    suite.expectUlp(name("OscI+OscI*env>LowP", "chain", v), refOut, render(u, block, blocks, feeds), 0);
+}
+
+int main()
+{
+    Suite suite("test_static");
+    Random rnd(49);
+
+    for (size_t v : { 1, 7, 64, 333 })
+    {
+        testGenerators(suite, rnd, v);
+        testFilters(suite, rnd, v);
+        testChain(suite, rnd, v);
+    }
+    return suite.finish();
+}
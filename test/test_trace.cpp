@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////
+// test_trace: events and export of the tracing build
+//
+// Copyright (C) 2024 Albert Madrenys
+//
+// This software is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 3.0 of the License, or (at your option) any later version.
+//
+/////////////////////////////////////////////////////////////////////
+#include <sstream>
+#include <thread>
+#include "TestUtil.h"
+#include "FuncTab.h"
+#include "Osc.h"
+#include "Butterworth.h"
+#ifdef KIWIWAVES_TRACE
+#include "Trace.h"
+#endif
+
+using namespace KiwiWaves;
+using namespace KiwiWaves::Test;
+
+#ifdef KIWIWAVES_TRACE
+static size_t count(const std::string& s, const std::string& what)
+{
+    size_t n = 0;
+    for (size_t pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + 1)) n++;
+    return n;
+}
+#endif
+
+int main()
+{
+    Suite suite("test_trace");
+#ifdef KIWIWAVES_TRACE
+    std::vector<double> saw(1024);
+    for (size_t k = 0; k < saw.size(); k++) saw[k] = 2. * k / saw.size() - 1.;
+    FuncTab tab(saw);
+
+    // A block of a filter pulling its oscillator on each of two threads
+    auto patch = [&](const char* thread, size_t blocks)
+    {
+        Trace::setThreadName(thread);
+        OscI osc(0.5, 110., tab);
+        LowP lp(osc, 2000.);
+        for (size_t b = 0; b < blocks; b++)
+        {
+            Trace::Block block;
+            lp.process();
+        }
+    };
+    std::thread t1(patch, "audio 1", 100), t2(patch, "audio 2", 100);
+    t1.join();
+    t2.join();
+
+    std::ostringstream os;
+    Trace::write(os);
+    std::string json = os.str();
+    suite.check("thread names", count(json, "\"audio 1\"") == 1 && count(json, "\"audio 2\"") == 1);
+    suite.check("block spans", count(json, "{\"name\":\"block\"") == 400, std::to_string(count(json, "\"block\"")));
+    suite.check("ugen spans", count(json, "{\"name\":\"LowP\"") == 400 && count(json, "{\"name\":\"OscI\"") == 400);
+    suite.check("balanced", count(json, "\"ph\":\"B\"") == count(json, "\"ph\":\"E\""));
+
+    // Past the capacity of the ring the oldest events are dropped,
+    // and the spans cut by the wrap around are left out
+    Trace::clear();
+    std::thread t3(patch, "audio 3", def_trace_capacity / 4 + 1001);
+    t3.join();
+    os.str("");
+    Trace::write(os);
+    json = os.str();
+    size_t begins = count(json, "\"ph\":\"B\""), ends = count(json, "\"ph\":\"E\"");
+    suite.check("wrapped and balanced", begins == ends && begins <= def_trace_capacity / 2 &&
+        begins + 3 >= def_trace_capacity / 2, std::to_string(begins) + " begins, " + std::to_string(ends) + " ends");
+
+    Trace::clear();
+    Trace::enable(false);
+    patch("audio 4", 10);
+    os.str("");
+    Trace::write(os);
+    suite.check("disabled", count(json = os.str(), "\"ph\":\"B\"") == 0);
+#endif
+    return suite.finish();
+}